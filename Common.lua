@@ -16,7 +16,7 @@ function BuildPaths()
 end
 
 function DefinePlatforms()
-	platforms { "Win64" }
+	platforms { "Win64", "Linux64" }
 end
 
 function UseWindowsSettings(extra_define)
@@ -29,6 +29,16 @@ function UseWindowsSettings(extra_define)
 	filter {}
 end
 
+function UseLinuxSettings(extra_define)
+	filter "platforms:Linux64"
+		defines { "PLATFORM_LINUX=1", extra_define }
+		system "Linux"
+		toolset "clang"
+		architecture "x86_64"
+
+	filter {}
+end
+
 function DefineConfigurations()
 	configurations { "Debug", "Profile", "Release" }
 end
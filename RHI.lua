@@ -2,6 +2,7 @@ include "Common.lua"
 
 project "RHI"
 	kind "StaticLib"
+	removeplatforms { "Linux64" }
 
 	SetConfigurationSettings()
 	UseWindowsSettings("RHI_D3D12=1")
@@ -0,0 +1,30 @@
+include "Common.lua"
+
+project "ShaderArchiver"
+	kind "ConsoleApp"
+
+	SetConfigurationSettings()
+	UseWindowsSettings("PLATFORM_LINUX=0")
+	UseLinuxSettings("PLATFORM_WINDOWS=0")
+
+	includedirs { "Source", "ThirdParty", "../Luft/Source" }
+
+	files
+	{
+		"Source/ShaderArchiver/**.cpp",
+		"Source/RHI/ShaderArchive.hpp",
+		"Source/RHI/ShaderReflection.hpp",
+		"Source/RHI/D3D12/ShaderReflection.hpp",
+		"Source/RHI/D3D12/ShaderReflection.cpp",
+	}
+
+	filter "platforms:Win64"
+		libdirs { "ThirdParty/dxc" }
+		links { "dxcompiler" }
+
+	-- The Linux DXC package provides libdxcompiler.so and the WinAdapter.h that dxcapi.h needs. Reflection also needs
+	-- the WSL-compatible d3dcommon.h from DirectX-Headers on the include path.
+	filter "platforms:Linux64"
+		links { "dxcompiler" }
+
+	filter {}
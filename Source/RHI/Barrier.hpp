@@ -27,6 +27,8 @@ enum class BarrierStage : uint32
 	EmitAccelerationStructureSizes = 0x4000,
 	BuildAccelerationStructure = 0x800000,
 	CopyAccelerationStructure = 0x1000000,
+	// The other half of a split barrier, set by the Begin and End barrier calls of GraphicsContext.
+	Split = 0x80000000,
 };
 FLAGS_ENUM(BarrierStage);
 
@@ -87,4 +89,22 @@ enum class BarrierLayout : uint32
 };
 FLAGS_ENUM(BarrierLayout);
 
+// The subresources a texture barrier covers. A zero count covers everything from the first index on, so a zeroed range
+// is the whole texture. Planes split depth from stencil; textures without stencil have one plane and one array slice.
+struct BarrierSubresourceRange
+{
+	uint32 FirstMip;
+	uint32 MipCount;
+	uint32 FirstArraySlice;
+	uint32 ArraySliceCount;
+	uint32 FirstPlane;
+	uint32 PlaneCount;
+
+	bool operator==(const BarrierSubresourceRange& other) const
+	{
+		return FirstMip == other.FirstMip && MipCount == other.MipCount && FirstArraySlice == other.FirstArraySlice &&
+			   ArraySliceCount == other.ArraySliceCount && FirstPlane == other.FirstPlane && PlaneCount == other.PlaneCount;
+	}
+};
+
 }
@@ -4,6 +4,8 @@
 #include "Forward.hpp"
 #include "View.hpp"
 
+#include "Luft/Hash.hpp"
+
 namespace RHI
 {
 
@@ -11,6 +13,17 @@ struct BufferViewDescription
 {
 	ViewType Type;
 	Buffer Buffer;
+
+	// Where the view starts in the buffer, with Buffer.Size bytes from there on, so many small buffers can share one
+	// allocation. Constant buffer views need 256 byte alignment, structured views a multiple of the stride and raw
+	// views 16 bytes.
+	usize Offset;
+
+	bool operator==(const BufferViewDescription& other) const
+	{
+		return Type == other.Type && Buffer.Resource.Backend == other.Buffer.Resource.Backend &&
+			   Buffer.Size == other.Buffer.Size && Buffer.Stride == other.Buffer.Stride && Offset == other.Offset;
+	}
 };
 
 class BufferView final : public BufferViewDescription
@@ -34,4 +47,36 @@ public:
 	RHI_BACKEND(BufferView)* Backend;
 };
 
+inline BufferViewDescription ViewSubBuffer(ViewType type, const SubBuffer& subBuffer)
+{
+	return BufferViewDescription
+	{
+		.Type = type,
+		.Buffer =
+		{
+			.Resource = subBuffer.Resource,
+			.Size = subBuffer.Size,
+			.Stride = subBuffer.Stride,
+		},
+		.Offset = subBuffer.Offset,
+	};
+}
+
 }
+
+template<>
+struct Hash<RHI::BufferViewDescription>
+{
+	uint64 operator()(const RHI::BufferViewDescription& key) const
+	{
+		const uint64 values[] =
+		{
+			reinterpret_cast<uintptr_t>(key.Buffer.Resource.Backend),
+			static_cast<uint64>(key.Type),
+			key.Buffer.Size,
+			key.Buffer.Stride,
+			key.Offset,
+		};
+		return HashFnv1a(values, sizeof(values));
+	}
+};
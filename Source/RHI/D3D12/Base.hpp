@@ -26,6 +26,7 @@ inline constexpr DXGI_SAMPLE_DESC DefaultSampleDescription = { 1, 0 };
 inline constexpr usize MaxRenderTargetCount = D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT;
 
 inline constexpr D3D12_RANGE ReadNothing = { 0, 0 };
+inline constexpr const D3D12_RANGE* ReadEverything = nullptr;
 inline constexpr D3D12_RANGE WriteNothing = { 0, 0 };
 inline constexpr const D3D12_RANGE* WriteEverything = nullptr;
 
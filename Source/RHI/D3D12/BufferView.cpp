@@ -11,6 +11,7 @@ BufferView::BufferView(const BufferViewDescription& description, D3D12::Device*
 	, Device(device)
 {
 	CHECK(Buffer.Resource.IsValid());
+	CHECK(Offset + Buffer.Size <= Buffer.Resource.Size);
 	const D3D12::Resource* backendResource = Buffer.Resource.Backend;
 
 	switch (Type)
@@ -37,6 +38,7 @@ BufferView::BufferView(const BufferViewDescription& description, D3D12::Device*
 
 		const D3D12_UNORDERED_ACCESS_VIEW_DESC unorderedAccessDescription = To<ViewType::UnorderedAccess>(description);
 		device->Native->CreateUnorderedAccessView(backendResource->Native, nullptr, &unorderedAccessDescription, GetCpu());
+		device->Native->CreateUnorderedAccessView(backendResource->Native, nullptr, &unorderedAccessDescription, GetClearCpu());
 		break;
 	}
 	default:
@@ -54,4 +56,10 @@ D3D12_GPU_DESCRIPTOR_HANDLE BufferView::GetGpu() const
 	return Device->GetGpu(HeapIndex, Type);
 }
 
+D3D12_CPU_DESCRIPTOR_HANDLE BufferView::GetClearCpu() const
+{
+	CHECK(Type == ViewType::UnorderedAccess);
+	return Device->UnorderedAccessClearViewHeap.GetCpu(HeapIndex);
+}
+
 }
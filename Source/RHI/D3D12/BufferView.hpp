@@ -14,6 +14,7 @@ public:
 
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCpu() const;
 	D3D12_GPU_DESCRIPTOR_HANDLE GetGpu() const;
+	D3D12_CPU_DESCRIPTOR_HANDLE GetClearCpu() const;
 
 	uint32 HeapIndex;
 	Device* Device;
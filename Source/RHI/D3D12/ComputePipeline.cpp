@@ -12,9 +12,11 @@ ComputePipeline::ComputePipeline(const ComputePipelineDescription& description,
 	, ComputePipelineDescription(description)
 {
 	const Shader* backendShader = Stage.Backend;
+	VERIFY(backendShader->Blob, "Shader bytecode was released before the pipeline was built!");
 
 	HashTable<String, D3D12_ROOT_PARAMETER1> apiRootParameters(BindingBucketCount, Allocator);
-	DXC::ReflectRootParameters(backendShader->Reflection, &RootParameters, &apiRootParameters);
+	Array<D3D12_STATIC_SAMPLER_DESC> staticSamplers(Allocator);
+	DXC::ReflectRootParameters(backendShader->Reflection, &RootParameters, &apiRootParameters, &staticSamplers);
 
 	Array<D3D12_ROOT_PARAMETER1> rootParametersList(apiRootParameters.GetCount(), Allocator);
 	for (auto& [_, rootParameter] : apiRootParameters)
@@ -29,32 +31,14 @@ ComputePipeline::ComputePipeline(const ComputePipelineDescription& description,
 		{
 			.NumParameters = static_cast<uint32>(rootParametersList.GetLength()),
 			.pParameters = rootParametersList.GetData(),
-			.NumStaticSamplers = 0,
-			.pStaticSamplers = nullptr,
+			.NumStaticSamplers = static_cast<uint32>(staticSamplers.GetLength()),
+			.pStaticSamplers = staticSamplers.GetData(),
 			.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
 					 D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED |
 					 D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED,
 		},
 	};
-	ID3DBlob* serializedRootSignature = nullptr;
-	ID3DBlob* errorBlob = nullptr;
-	const HRESULT rootSignatureResult = D3D12SerializeVersionedRootSignature(&rootSignatureDescription, &serializedRootSignature, &errorBlob);
-#if DEBUG
-	if (FAILED(rootSignatureResult) && errorBlob)
-	{
-		char errorMessage[512] = {};
-		Platform::StringPrint("Root Signature Error: %s\n", errorMessage, sizeof(errorMessage), errorBlob->GetBufferPointer());
-		Platform::FatalError(errorMessage);
-	}
-#else
-	(void)rootSignatureResult;
-#endif
-	CHECK(serializedRootSignature);
-	CHECK_RESULT(device->Native->CreateRootSignature(0,
-													 serializedRootSignature->GetBufferPointer(),
-													 serializedRootSignature->GetBufferSize(),
-													 IID_PPV_ARGS(&RootSignature)));
-	SET_D3D_NAME(RootSignature, Name);
+	device->CreateRootSignature(rootSignatureDescription, &RootSignature);
 
 	const D3D12_COMPUTE_PIPELINE_STATE_DESC computePipelineStateDescription =
 	{
@@ -68,10 +52,24 @@ ComputePipeline::ComputePipeline(const ComputePipelineDescription& description,
 		.CachedPSO = {},
 		.Flags = D3D12_PIPELINE_STATE_FLAG_NONE,
 	};
-	CHECK_RESULT(device->Native->CreateComputePipelineState(&computePipelineStateDescription, IID_PPV_ARGS(&PipelineState)));
+	device->CreatePipelineState(computePipelineStateDescription, &PipelineState);
 	SET_D3D_NAME(PipelineState, Name);
 }
 
+#if !RELEASE
+bool ComputePipeline::UsesReloadedShader() const
+{
+	return Stage.Backend->Reloaded;
+}
+
+void ComputePipeline::Rebuild(RetiredPipeline* retired)
+{
+	ComputePipeline* replacement = Allocator->Create<ComputePipeline>(static_cast<const ComputePipelineDescription&>(*this), Device);
+	Replace(replacement, retired);
+	Allocator->Destroy(replacement);
+}
+#endif
+
 void ComputePipeline::SetConstantBuffer(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
 {
 	const DXC::RootParameter& rootParameter = RootParameters[name];
@@ -83,6 +81,32 @@ void ComputePipeline::SetConstantBuffer(ID3D12GraphicsCommandList10* commandList
 	);
 }
 
+void ComputePipeline::SetShaderResource(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
+{
+	CHECK(RootParameters.Contains(name));
+	const DXC::RootParameter& rootParameter = RootParameters[name];
+	CHECK(rootParameter.Type == ReflectedBindingType::ShaderResource);
+
+	commandList->SetComputeRootShaderResourceView
+	(
+		static_cast<uint32>(rootParameter.Index),
+		D3D12_GPU_VIRTUAL_ADDRESS { buffer->Native->GetGPUVirtualAddress() + offset }
+	);
+}
+
+void ComputePipeline::SetUnorderedAccess(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
+{
+	CHECK(RootParameters.Contains(name));
+	const DXC::RootParameter& rootParameter = RootParameters[name];
+	CHECK(rootParameter.Type == ReflectedBindingType::UnorderedAccess);
+
+	commandList->SetComputeRootUnorderedAccessView
+	(
+		static_cast<uint32>(rootParameter.Index),
+		D3D12_GPU_VIRTUAL_ADDRESS { buffer->Native->GetGPUVirtualAddress() + offset }
+	);
+}
+
 void ComputePipeline::SetConstants(ID3D12GraphicsCommandList10* commandList, const void* data)
 {
 	static const StringView name = "RootConstants"_view;
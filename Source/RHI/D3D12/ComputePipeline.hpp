@@ -13,7 +13,14 @@ public:
 	ComputePipeline(const ComputePipelineDescription& description, D3D12::Device* device);
 
 	virtual void SetConstantBuffer(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
+	virtual void SetShaderResource(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
+	virtual void SetUnorderedAccess(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
 	virtual void SetConstants(ID3D12GraphicsCommandList10* commandList, const void* data) override;
+
+#if !RELEASE
+	virtual bool UsesReloadedShader() const override;
+	virtual void Rebuild(RetiredPipeline* retired) override;
+#endif
 };
 
 }
@@ -2,6 +2,8 @@
 
 #include "AccelerationStructure.hpp"
 #include "BufferView.hpp"
+#include "GraphicsPipeline.hpp"
+#include "QueryPool.hpp"
 #include "Resource.hpp"
 #include "Sampler.hpp"
 #include "TextureView.hpp"
@@ -34,6 +36,41 @@ inline D3D12_BARRIER_LAYOUT To(BarrierLayout layout)
 	return static_cast<D3D12_BARRIER_LAYOUT>(layout);
 }
 
+inline D3D12_BARRIER_SUBRESOURCE_RANGE To(const BarrierSubresourceRange& range, const ResourceDescription& texture)
+{
+	const uint32 mipCount = texture.MipMapCount != 0 ? texture.MipMapCount : 1;
+	const uint32 arraySliceCount = 1;
+	const uint32 planeCount = IsStencilFormat(texture.Format) ? 2 : 1;
+	CHECK(range.FirstMip < mipCount && range.FirstMip + range.MipCount <= mipCount);
+	CHECK(range.FirstArraySlice < arraySliceCount && range.FirstArraySlice + range.ArraySliceCount <= arraySliceCount);
+	CHECK(range.FirstPlane < planeCount && range.FirstPlane + range.PlaneCount <= planeCount);
+
+	// The whole texture keeps the single subresource index that needs no range.
+	if (range.FirstMip == 0 && range.MipCount == 0 && range.FirstArraySlice == 0 && range.ArraySliceCount == 0 &&
+		range.FirstPlane == 0 && range.PlaneCount == 0)
+	{
+		return D3D12_BARRIER_SUBRESOURCE_RANGE
+		{
+			.IndexOrFirstMipLevel = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
+			.NumMipLevels = 0,
+			.FirstArraySlice = 0,
+			.NumArraySlices = 0,
+			.FirstPlane = 0,
+			.NumPlanes = 0,
+		};
+	}
+
+	return D3D12_BARRIER_SUBRESOURCE_RANGE
+	{
+		.IndexOrFirstMipLevel = range.FirstMip,
+		.NumMipLevels = range.MipCount != 0 ? range.MipCount : mipCount - range.FirstMip,
+		.FirstArraySlice = range.FirstArraySlice,
+		.NumArraySlices = range.ArraySliceCount != 0 ? range.ArraySliceCount : arraySliceCount - range.FirstArraySlice,
+		.FirstPlane = range.FirstPlane,
+		.NumPlanes = range.PlaneCount != 0 ? range.PlaneCount : planeCount - range.FirstPlane,
+	};
+}
+
 inline D3D12_RESOURCE_FLAGS To(ResourceFlags flags)
 {
 	D3D12_RESOURCE_FLAGS nativeFlags = D3D12_RESOURCE_FLAG_NONE;
@@ -200,6 +237,42 @@ inline D3D12_HEAP_DESC To(const HeapDescription& description)
 	};
 }
 
+inline D3D12_QUERY_TYPE To(QueryType type)
+{
+	switch (type)
+	{
+	case QueryType::Occlusion:
+		return D3D12_QUERY_TYPE_OCCLUSION;
+	case QueryType::BinaryOcclusion:
+		return D3D12_QUERY_TYPE_BINARY_OCCLUSION;
+	}
+	CHECK(false);
+	return D3D12_QUERY_TYPE_OCCLUSION;
+}
+
+inline D3D12_QUERY_HEAP_DESC To(const QueryPoolDescription& description)
+{
+	return D3D12_QUERY_HEAP_DESC
+	{
+		.Type = D3D12_QUERY_HEAP_TYPE_OCCLUSION,
+		.Count = static_cast<uint32>(description.Count),
+		.NodeMask = 0,
+	};
+}
+
+inline D3D12_PREDICATION_OP To(PredicationOperation operation)
+{
+	switch (operation)
+	{
+	case PredicationOperation::EqualZero:
+		return D3D12_PREDICATION_OP_EQUAL_ZERO;
+	case PredicationOperation::NotEqualZero:
+		return D3D12_PREDICATION_OP_NOT_EQUAL_ZERO;
+	}
+	CHECK(false);
+	return D3D12_PREDICATION_OP_EQUAL_ZERO;
+}
+
 inline D3D12_RAYTRACING_GEOMETRY_DESC To(const AccelerationStructureGeometry& geometry)
 {
 	CHECK(geometry.VertexBuffer.Stride == sizeof(float[3]));
@@ -292,13 +365,18 @@ inline ToViewType<ViewType::ShaderResource>::Type To(const AccelerationStructure
 
 inline ToViewType<ViewType::ConstantBuffer>::Type To(const BufferViewDescription& description, const Resource* resource)
 {
+	CHECK(description.Offset % D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT == 0);
+
 	return
 	{
-		.BufferLocation = resource->Native->GetGPUVirtualAddress(),
+		.BufferLocation = resource->Native->GetGPUVirtualAddress() + description.Offset,
 		.SizeInBytes = static_cast<uint32>(description.Buffer.Size),
 	};
 }
 
+// Raw views count elements in 32-bit words, but must start on a 16 byte boundary.
+inline constexpr usize RawBufferViewAlignment = 16;
+
 template<ViewType V>
 typename ToViewType<V>::Type To(const BufferViewDescription& description);
 
@@ -306,9 +384,11 @@ template<>
 inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(const BufferViewDescription& description)
 {
 	const bool byteAddressBuffer = description.Buffer.Stride == 0;
+	const usize elementSize = byteAddressBuffer ? sizeof(uint32) : description.Buffer.Stride;
+	CHECK(description.Offset % (byteAddressBuffer ? RawBufferViewAlignment : elementSize) == 0);
 
 	const DXGI_FORMAT format = byteAddressBuffer ? DXGI_FORMAT_R32_TYPELESS : DXGI_FORMAT_UNKNOWN;
-	const usize count = byteAddressBuffer ? (description.Buffer.Size / 4) : (description.Buffer.Size / description.Buffer.Stride);
+	const usize count = description.Buffer.Size / elementSize;
 	const D3D12_BUFFER_SRV_FLAGS flags = byteAddressBuffer ? D3D12_BUFFER_SRV_FLAG_RAW : D3D12_BUFFER_SRV_FLAG_NONE;
 
 	return
@@ -318,7 +398,7 @@ inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(c
 		.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
 		.Buffer = D3D12_BUFFER_SRV
 		{
-			.FirstElement = 0,
+			.FirstElement = description.Offset / elementSize,
 			.NumElements = static_cast<uint32>(count),
 			.StructureByteStride = static_cast<uint32>(description.Buffer.Stride),
 			.Flags = flags,
@@ -329,13 +409,15 @@ inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(c
 template<>
 inline ToViewType<ViewType::UnorderedAccess>::Type To<ViewType::UnorderedAccess>(const BufferViewDescription& description)
 {
+	CHECK(description.Offset % RawBufferViewAlignment == 0);
+
 	return
 	{
 		.Format = DXGI_FORMAT_R32_TYPELESS,
 		.ViewDimension = D3D12_UAV_DIMENSION_BUFFER,
 		.Buffer =
 		{
-			.FirstElement = 0,
+			.FirstElement = description.Offset / sizeof(uint32),
 			.NumElements = static_cast<uint32>(description.Buffer.Size / sizeof(uint32)),
 			.StructureByteStride = 0,
 			.CounterOffsetInBytes = 0,
@@ -350,6 +432,9 @@ typename ToViewType<V>::Type To(const TextureViewDescription& description);
 template<>
 inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(const TextureViewDescription& description)
 {
+	const uint32 mipCount = description.Resource.MipMapCount != 0 ? description.Resource.MipMapCount : 1;
+	CHECK(description.FirstMip < mipCount && description.FirstMip + description.MipCount <= mipCount);
+
 	return
 	{
 		.Format = To(description.Resource.Format),
@@ -357,8 +442,8 @@ inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(c
 		.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
 		.Texture2D = D3D12_TEX2D_SRV
 		{
-			.MostDetailedMip = 0,
-			.MipLevels = description.Resource.MipMapCount != 0 ? description.Resource.MipMapCount : static_cast<uint16>(1),
+			.MostDetailedMip = description.FirstMip,
+			.MipLevels = description.MipCount != 0 ? description.MipCount : mipCount - description.FirstMip,
 			.PlaneSlice = 0,
 			.ResourceMinLODClamp = 0,
 		},
@@ -368,13 +453,15 @@ inline ToViewType<ViewType::ShaderResource>::Type To<ViewType::ShaderResource>(c
 template<>
 inline ToViewType<ViewType::UnorderedAccess>::Type To<ViewType::UnorderedAccess>(const TextureViewDescription& description)
 {
+	CHECK(description.MipCount <= 1);
+
 	return
 	{
 		.Format = To(description.Resource.Format),
 		.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D,
 		.Texture2D = D3D12_TEX2D_UAV
 		{
-			.MipSlice = 0,
+			.MipSlice = description.FirstMip,
 			.PlaneSlice = 0,
 		},
 	};
@@ -383,13 +470,15 @@ inline ToViewType<ViewType::UnorderedAccess>::Type To<ViewType::UnorderedAccess>
 template<>
 inline ToViewType<ViewType::RenderTarget>::Type To<ViewType::RenderTarget>(const TextureViewDescription& description)
 {
+	CHECK(description.MipCount <= 1);
+
 	return
 	{
 		.Format = To(description.Resource.Format),
 		.ViewDimension = D3D12_RTV_DIMENSION_TEXTURE2D,
 		.Texture2D = D3D12_TEX2D_RTV
 		{
-			.MipSlice = 0,
+			.MipSlice = description.FirstMip,
 			.PlaneSlice = 0,
 		},
 	};
@@ -398,6 +487,8 @@ inline ToViewType<ViewType::RenderTarget>::Type To<ViewType::RenderTarget>(const
 template<>
 inline ToViewType<ViewType::DepthStencil>::Type To<ViewType::DepthStencil>(const TextureViewDescription& description)
 {
+	CHECK(description.MipCount <= 1);
+
 	return
 	{
 		.Format = To(description.Resource.Format),
@@ -405,7 +496,7 @@ inline ToViewType<ViewType::DepthStencil>::Type To<ViewType::DepthStencil>(const
 		.Flags = D3D12_DSV_FLAG_NONE,
 		.Texture2D =
 		{
-			.MipSlice = 0,
+			.MipSlice = description.FirstMip,
 		},
 	};
 }
@@ -428,18 +519,231 @@ inline ToViewType<ViewType::Sampler>::Type To(const SamplerDescription& descript
 	};
 }
 
-inline DXGI_FORMAT MaskToFormat(uint8 mask)
+inline D3D12_CULL_MODE To(CullMode cullMode)
 {
-	switch (mask)
+	switch (cullMode)
 	{
-	case 0b0001:
+	case CullMode::Back:
+		return D3D12_CULL_MODE_BACK;
+	case CullMode::Front:
+		return D3D12_CULL_MODE_FRONT;
+	case CullMode::None:
+		return D3D12_CULL_MODE_NONE;
+	}
+	CHECK(false);
+	return D3D12_CULL_MODE_BACK;
+}
+
+inline D3D12_COMPARISON_FUNC To(ComparisonFunction function, bool reverseDepth)
+{
+	switch (function)
+	{
+	case ComparisonFunction::Default:
+		return reverseDepth ? D3D12_COMPARISON_FUNC_GREATER_EQUAL : D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	case ComparisonFunction::Never:
+		return D3D12_COMPARISON_FUNC_NEVER;
+	case ComparisonFunction::Less:
+		return D3D12_COMPARISON_FUNC_LESS;
+	case ComparisonFunction::Equal:
+		return D3D12_COMPARISON_FUNC_EQUAL;
+	case ComparisonFunction::LessEqual:
+		return D3D12_COMPARISON_FUNC_LESS_EQUAL;
+	case ComparisonFunction::Greater:
+		return D3D12_COMPARISON_FUNC_GREATER;
+	case ComparisonFunction::NotEqual:
+		return D3D12_COMPARISON_FUNC_NOT_EQUAL;
+	case ComparisonFunction::GreaterEqual:
+		return D3D12_COMPARISON_FUNC_GREATER_EQUAL;
+	case ComparisonFunction::Always:
+		return D3D12_COMPARISON_FUNC_ALWAYS;
+	}
+	CHECK(false);
+	return D3D12_COMPARISON_FUNC_LESS_EQUAL;
+}
+
+inline D3D12_RENDER_TARGET_BLEND_DESC To(RenderTargetBlend blend, bool alphaBlend)
+{
+	BlendMode mode = blend.Blend;
+	if (mode == BlendMode::Default)
+	{
+		mode = alphaBlend ? BlendMode::Alpha : BlendMode::Opaque;
+	}
+
+	D3D12_RENDER_TARGET_BLEND_DESC nativeBlend =
+	{
+		.BlendEnable = mode != BlendMode::Opaque,
+		.LogicOpEnable = false,
+		.SrcBlend = D3D12_BLEND_ONE,
+		.DestBlend = D3D12_BLEND_ZERO,
+		.BlendOp = D3D12_BLEND_OP_ADD,
+		.SrcBlendAlpha = D3D12_BLEND_ONE,
+		.DestBlendAlpha = D3D12_BLEND_ZERO,
+		.BlendOpAlpha = D3D12_BLEND_OP_ADD,
+		.LogicOp = D3D12_LOGIC_OP_NOOP,
+		.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL,
+	};
+	switch (mode)
+	{
+	case BlendMode::Alpha:
+		nativeBlend.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+		nativeBlend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+		break;
+	case BlendMode::Additive:
+		nativeBlend.DestBlend = D3D12_BLEND_ONE;
+		nativeBlend.DestBlendAlpha = D3D12_BLEND_ONE;
+		break;
+	case BlendMode::Premultiplied:
+		nativeBlend.DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+		nativeBlend.DestBlendAlpha = D3D12_BLEND_INV_SRC_ALPHA;
+		break;
+	default:
+		break;
+	}
+
+	switch (blend.Write)
+	{
+	case ColorWrite::All:
+		break;
+	case ColorWrite::Color:
+		nativeBlend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_RED | D3D12_COLOR_WRITE_ENABLE_GREEN | D3D12_COLOR_WRITE_ENABLE_BLUE;
+		break;
+	case ColorWrite::Alpha:
+		nativeBlend.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALPHA;
+		break;
+	case ColorWrite::None:
+		nativeBlend.RenderTargetWriteMask = 0;
+		break;
+	}
+	return nativeBlend;
+}
+
+inline D3D12_PRIMITIVE_TOPOLOGY_TYPE ToType(PrimitiveTopology topology)
+{
+	switch (topology)
+	{
+	case PrimitiveTopology::TriangleList:
+	case PrimitiveTopology::TriangleStrip:
+		return D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	case PrimitiveTopology::LineList:
+	case PrimitiveTopology::LineStrip:
+		return D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+	case PrimitiveTopology::PointList:
+		return D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT;
+	}
+	CHECK(false);
+	return D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+}
+
+inline D3D_PRIMITIVE_TOPOLOGY To(PrimitiveTopology topology)
+{
+	switch (topology)
+	{
+	case PrimitiveTopology::TriangleList:
+		return D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+	case PrimitiveTopology::TriangleStrip:
+		return D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+	case PrimitiveTopology::LineList:
+		return D3D_PRIMITIVE_TOPOLOGY_LINELIST;
+	case PrimitiveTopology::LineStrip:
+		return D3D_PRIMITIVE_TOPOLOGY_LINESTRIP;
+	case PrimitiveTopology::PointList:
+		return D3D_PRIMITIVE_TOPOLOGY_POINTLIST;
+	}
+	CHECK(false);
+	return D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+}
+
+inline D3D12_STATIC_SAMPLER_DESC To(StaticSampler sampler)
+{
+	D3D12_FILTER filter = D3D12_FILTER_MIN_MAG_MIP_POINT;
+	D3D12_TEXTURE_ADDRESS_MODE address = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
+	switch (sampler)
+	{
+	case StaticSampler::PointWrap:
+		break;
+	case StaticSampler::PointClamp:
+		address = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		break;
+	case StaticSampler::LinearWrap:
+		filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+		break;
+	case StaticSampler::LinearClamp:
+		filter = D3D12_FILTER_MIN_MAG_MIP_LINEAR;
+		address = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		break;
+	case StaticSampler::AnisotropicWrap:
+		filter = D3D12_FILTER_ANISOTROPIC;
+		break;
+	case StaticSampler::AnisotropicClamp:
+		filter = D3D12_FILTER_ANISOTROPIC;
+		address = D3D12_TEXTURE_ADDRESS_MODE_CLAMP;
+		break;
+	default:
+		CHECK(false);
+	}
+
+	return D3D12_STATIC_SAMPLER_DESC
+	{
+		.Filter = filter,
+		.AddressU = address,
+		.AddressV = address,
+		.AddressW = address,
+		.MipLODBias = 0.0f,
+		.MaxAnisotropy = D3D12_DEFAULT_MAX_ANISOTROPY,
+		.ComparisonFunc = D3D12_COMPARISON_FUNC_NEVER,
+		.BorderColor = D3D12_STATIC_BORDER_COLOR_TRANSPARENT_BLACK,
+		.MinLOD = 0.0f,
+		.MaxLOD = D3D12_FLOAT32_MAX,
+		.ShaderRegister = static_cast<uint32>(sampler),
+		.RegisterSpace = StaticSamplerSpace,
+		.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL,
+	};
+}
+
+inline DXGI_FORMAT To(VertexFormat format)
+{
+	switch (format)
+	{
+	case VertexFormat::Float32:
 		return DXGI_FORMAT_R32_FLOAT;
-	case 0b0011:
+	case VertexFormat::Float32x2:
 		return DXGI_FORMAT_R32G32_FLOAT;
-	case 0b0111:
+	case VertexFormat::Float32x3:
 		return DXGI_FORMAT_R32G32B32_FLOAT;
-	case 0b1111:
+	case VertexFormat::Float32x4:
 		return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VertexFormat::Float16x2:
+		return DXGI_FORMAT_R16G16_FLOAT;
+	case VertexFormat::Float16x4:
+		return DXGI_FORMAT_R16G16B16A16_FLOAT;
+	case VertexFormat::SNorm16x2:
+		return DXGI_FORMAT_R16G16_SNORM;
+	case VertexFormat::SNorm16x4:
+		return DXGI_FORMAT_R16G16B16A16_SNORM;
+	case VertexFormat::UNorm16x2:
+		return DXGI_FORMAT_R16G16_UNORM;
+	case VertexFormat::UNorm16x4:
+		return DXGI_FORMAT_R16G16B16A16_UNORM;
+	case VertexFormat::SNorm8x4:
+		return DXGI_FORMAT_R8G8B8A8_SNORM;
+	case VertexFormat::UNorm8x4:
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+	case VertexFormat::UNorm10x3A2:
+		return DXGI_FORMAT_R10G10B10A2_UNORM;
+	case VertexFormat::UInt8x4:
+		return DXGI_FORMAT_R8G8B8A8_UINT;
+	case VertexFormat::UInt16x2:
+		return DXGI_FORMAT_R16G16_UINT;
+	case VertexFormat::UInt16x4:
+		return DXGI_FORMAT_R16G16B16A16_UINT;
+	case VertexFormat::UInt32:
+		return DXGI_FORMAT_R32_UINT;
+	case VertexFormat::UInt32x2:
+		return DXGI_FORMAT_R32G32_UINT;
+	case VertexFormat::UInt32x3:
+		return DXGI_FORMAT_R32G32B32_UINT;
+	case VertexFormat::UInt32x4:
+		return DXGI_FORMAT_R32G32B32A32_UINT;
 	default:
 		break;
 	}
@@ -447,4 +751,42 @@ inline DXGI_FORMAT MaskToFormat(uint8 mask)
 	return DXGI_FORMAT_UNKNOWN;
 }
 
+// There are no three component 16-bit formats, so three component 16-bit inputs read four and ignore the last.
+inline DXGI_FORMAT To(const ReflectedInputElement& inputElement)
+{
+	static constexpr DXGI_FORMAT formats[][4] =
+	{
+		{ DXGI_FORMAT_R32_FLOAT, DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT },
+		{ DXGI_FORMAT_R16_FLOAT, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT, DXGI_FORMAT_R16G16B16A16_FLOAT },
+		{ DXGI_FORMAT_R32_UINT, DXGI_FORMAT_R32G32_UINT, DXGI_FORMAT_R32G32B32_UINT, DXGI_FORMAT_R32G32B32A32_UINT },
+		{ DXGI_FORMAT_R32_SINT, DXGI_FORMAT_R32G32_SINT, DXGI_FORMAT_R32G32B32_SINT, DXGI_FORMAT_R32G32B32A32_SINT },
+		{ DXGI_FORMAT_R16_UINT, DXGI_FORMAT_R16G16_UINT, DXGI_FORMAT_R16G16B16A16_UINT, DXGI_FORMAT_R16G16B16A16_UINT },
+		{ DXGI_FORMAT_R16_SINT, DXGI_FORMAT_R16G16_SINT, DXGI_FORMAT_R16G16B16A16_SINT, DXGI_FORMAT_R16G16B16A16_SINT },
+	};
+
+	usize componentCount = 0;
+	switch (inputElement.ComponentMask)
+	{
+	case 0b0001:
+		componentCount = 1;
+		break;
+	case 0b0011:
+		componentCount = 2;
+		break;
+	case 0b0111:
+		componentCount = 3;
+		break;
+	case 0b1111:
+		componentCount = 4;
+		break;
+	default:
+		CHECK(false);
+		return DXGI_FORMAT_UNKNOWN;
+	}
+
+	const usize componentType = static_cast<usize>(inputElement.ComponentType);
+	CHECK(componentType < ARRAY_COUNT(formats));
+	return formats[componentType][componentCount - 1];
+}
+
 }
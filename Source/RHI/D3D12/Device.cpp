@@ -4,12 +4,22 @@
 #include "BufferView.hpp"
 #include "ComputePipeline.hpp"
 #include "Convert.hpp"
+#include "Fence.hpp"
 #include "GraphicsContext.hpp"
 #include "GraphicsPipeline.hpp"
 #include "Heap.hpp"
+#include "HotReload.hpp"
+#include "PipelineCompiler.hpp"
+#include "PipelineLibrary.hpp"
+#include "PipelineManifest.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 #include "Resource.hpp"
+#include "RootSignatureCache.hpp"
 #include "Sampler.hpp"
 #include "Shader.hpp"
+#include "ShaderArchive.hpp"
+#include "ShaderCache.hpp"
 #include "TextureView.hpp"
 
 #include <dxgi1_6.h>
@@ -30,13 +40,28 @@ namespace RHI::D3D12
 {
 
 static constexpr DXGI_FORMAT SwapChainFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
-
-Device::Device(const Platform::Window* window)
-	: FrameFenceValues()
+static constexpr uint32 SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+Device::Device(const DeviceDescription& description)
+	: SwapChain(nullptr)
+	, FramesInFlight(description.FramesInFlight != 0 ? description.FramesInFlight : DefaultFramesInFlight)
+	, FrameIndex(0)
+	, FrameCount(0)
+	, FrameFenceValues()
+	, FrameLatencyWaitable(nullptr)
+	, MostRecentFrameWaitTime(0.0)
+	, RootSignatures(nullptr)
+	, PipelineCache(nullptr)
+	, AsyncPipelineCompiler(nullptr)
+	, WarmUpManifest(nullptr)
+	, WarmUpTime(0.0)
+#if !RELEASE
+	, ShaderHotReload(nullptr)
+#endif
 {
-	CHECK(window);
+	CHECK(FramesInFlight >= MinFramesInFlight && FramesInFlight <= MaxFramesInFlight);
 
-	DXC::Init();
+	DXC::Init(description.ShaderCachePath, description.ShaderCacheSize, description.ShaderArchivePath);
 
 	IDXGIFactory7* dxgiFactory = nullptr;
 	uint32 dxgiFlags = 0;
@@ -100,28 +125,10 @@ Device::Device(const Platform::Window* window)
 	};
 	CHECK_RESULT(Native->CreateCommandQueue(&graphicsQueueDescription, IID_PPV_ARGS(&GraphicsQueue)));
 
-	const HWND windowHandle = static_cast<HWND>(window->Handle);
-	static constexpr DXGI_SWAP_CHAIN_DESC1 swapChainDescription =
+	if (description.Window)
 	{
-		.Width = 0,
-		.Height = 0,
-		.Format = SwapChainFormat,
-		.Stereo = false,
-		.SampleDesc = DefaultSampleDescription,
-		.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT | DXGI_USAGE_BACK_BUFFER,
-		.BufferCount = FramesInFlight,
-		.Scaling = DXGI_SCALING_STRETCH,
-		.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
-		.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED,
-		.Flags = 0,
-	};
-	static const constexpr DXGI_SWAP_CHAIN_FULLSCREEN_DESC* fullScreenSwapChainDescription = nullptr;
-	IDXGISwapChain1* swapChain = nullptr;
-	CHECK_RESULT(dxgiFactory->CreateSwapChainForHwnd(GraphicsQueue, windowHandle, &swapChainDescription, fullScreenSwapChainDescription, nullptr, &swapChain));
-	CHECK_RESULT(swapChain->QueryInterface(IID_PPV_ARGS(&SwapChain)));
-	SAFE_RELEASE(swapChain);
-
-	CHECK_RESULT(dxgiFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+		CreateSwapChain(dxgiFactory, description.Window);
+	}
 	SAFE_RELEASE(dxgiFactory);
 
 #if !RELEASE
@@ -136,13 +143,21 @@ Device::Device(const Platform::Window* window)
 	CHECK_RESULT(Native->CheckFeatureSupport(D3D12_FEATURE_SHADER_MODEL, &featureShaderModel, sizeof(featureShaderModel)));
 	VERIFY(featureShaderModel.HighestShaderModel >= D3D_SHADER_MODEL_6_6, "D3D12: Expected Shader Model 6.6 support!");
 
-	CHECK_RESULT(Native->CreateFence(FrameFenceValues[0], D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&FrameFence)));
+	FrameFence = Create(
+	{
+		.InitialValue = FrameFenceValues[0],
+		.Name = "Frame Fence"_view,
+	});
 	++FrameFenceValues[0];
 
 	ConstantBufferShaderResourceUnorderedAccessViewHeap.Create(D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1,
 															   D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
 															   true,
 															   this);
+	UnorderedAccessClearViewHeap.Create(D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1,
+										D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
+										false,
+										this);
 	RenderTargetViewHeap.Create(D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, false, this);
 	DepthStencilViewHeap.Create(D3D12_MAX_SHADER_VISIBLE_DESCRIPTOR_HEAP_SIZE_TIER_1, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, false, this);
 	SamplerViewHeap.Create(D3D12_MAX_SHADER_VISIBLE_SAMPLER_HEAP_SIZE, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, true, this);
@@ -150,16 +165,66 @@ Device::Device(const Platform::Window* window)
 	uint64 timeStampFrequency;
 	CHECK_RESULT(GraphicsQueue->GetTimestampFrequency(&timeStampFrequency));
 	TimeStampFrequency = static_cast<double>(timeStampFrequency);
+
+	LARGE_INTEGER performanceCounterFrequency;
+	QueryPerformanceFrequency(&performanceCounterFrequency);
+	PerformanceCounterFrequency = static_cast<double>(performanceCounterFrequency.QuadPart);
+
+	RootSignatures = Allocator->Create<RootSignatureCache>(this);
+	PipelineCache = Allocator->Create<PipelineLibrary>(description.PipelineCachePath, this);
+	if (description.PipelineManifestPath.GetLength() > 0)
+	{
+		WarmUpManifest = Allocator->Create<PipelineManifest>(description.PipelineManifestPath);
+	}
+
+#if !RELEASE
+	if (description.ShaderHotReloadPath.GetLength() > 0)
+	{
+		ShaderHotReload = Allocator->Create<HotReload>(description.ShaderHotReloadPath, this);
+	}
+#endif
 }
 
 Device::~Device()
 {
+	// Compiler threads take the hot reload lock while they build, so they are joined before it goes away.
+	if (AsyncPipelineCompiler)
+	{
+		Allocator->Destroy(AsyncPipelineCompiler);
+		AsyncPipelineCompiler = nullptr;
+	}
+
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		Allocator->Destroy(ShaderHotReload);
+		ShaderHotReload = nullptr;
+	}
+#endif
+	if (WarmUpManifest)
+	{
+		Allocator->Destroy(WarmUpManifest);
+		WarmUpManifest = nullptr;
+	}
+	Allocator->Destroy(PipelineCache);
+	PipelineCache = nullptr;
+	Allocator->Destroy(RootSignatures);
+	RootSignatures = nullptr;
+
 	ConstantBufferShaderResourceUnorderedAccessViewHeap.Destroy();
+	UnorderedAccessClearViewHeap.Destroy();
 	RenderTargetViewHeap.Destroy();
 	DepthStencilViewHeap.Destroy();
 	SamplerViewHeap.Destroy();
 
-	SAFE_RELEASE(FrameFence);
+	Destroy(FrameFence);
+	FrameFence = nullptr;
+
+	if (FrameLatencyWaitable)
+	{
+		CloseHandle(FrameLatencyWaitable);
+		FrameLatencyWaitable = nullptr;
+	}
 	SAFE_RELEASE(SwapChain);
 	SAFE_RELEASE(GraphicsQueue);
 	SAFE_RELEASE(Native);
@@ -173,6 +238,36 @@ Device::~Device()
 #endif
 }
 
+void Device::CreateSwapChain(IDXGIFactory7* dxgiFactory, const Platform::Window* window)
+{
+	const HWND windowHandle = static_cast<HWND>(window->Handle);
+	const DXGI_SWAP_CHAIN_DESC1 swapChainDescription =
+	{
+		.Width = 0,
+		.Height = 0,
+		.Format = SwapChainFormat,
+		.Stereo = false,
+		.SampleDesc = DefaultSampleDescription,
+		.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT | DXGI_USAGE_BACK_BUFFER,
+		.BufferCount = static_cast<uint32>(FramesInFlight),
+		.Scaling = DXGI_SCALING_STRETCH,
+		.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD,
+		.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED,
+		.Flags = SwapChainFlags,
+	};
+	static const constexpr DXGI_SWAP_CHAIN_FULLSCREEN_DESC* fullScreenSwapChainDescription = nullptr;
+	IDXGISwapChain1* swapChain = nullptr;
+	CHECK_RESULT(dxgiFactory->CreateSwapChainForHwnd(GraphicsQueue, windowHandle, &swapChainDescription, fullScreenSwapChainDescription, nullptr, &swapChain));
+	CHECK_RESULT(swapChain->QueryInterface(IID_PPV_ARGS(&SwapChain)));
+	SAFE_RELEASE(swapChain);
+
+	CHECK_RESULT(SwapChain->SetMaximumFrameLatency(static_cast<uint32>(FramesInFlight - 1)));
+	FrameLatencyWaitable = SwapChain->GetFrameLatencyWaitableObject();
+	CHECK(FrameLatencyWaitable);
+
+	CHECK_RESULT(dxgiFactory->MakeWindowAssociation(windowHandle, DXGI_MWA_NO_ALT_ENTER));
+}
+
 AccelerationStructure* Device::Create(const AccelerationStructureDescription& description)
 {
 	return Allocator->Create<AccelerationStructure>(description, this);
@@ -180,12 +275,35 @@ AccelerationStructure* Device::Create(const AccelerationStructureDescription& de
 
 BufferView* Device::Create(const BufferViewDescription& description)
 {
-	return Allocator->Create<BufferView>(description, this);
+	BufferView* bufferView = BufferViewCache.Acquire(description);
+	if (!bufferView)
+	{
+		bufferView = Allocator->Create<BufferView>(description, this);
+		BufferViewCache.Add(description, bufferView);
+	}
+	return bufferView;
 }
 
 ComputePipeline* Device::Create(const ComputePipelineDescription& description)
 {
-	return Allocator->Create<ComputePipeline>(description, this);
+	if (WarmUpManifest)
+	{
+		WarmUpManifest->Record(description);
+	}
+
+	ComputePipeline* computePipeline = Allocator->Create<ComputePipeline>(description, this);
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Add(computePipeline);
+	}
+#endif
+	return computePipeline;
+}
+
+Fence* Device::Create(const FenceDescription& description)
+{
+	return Allocator->Create<Fence>(description, this);
 }
 
 GraphicsContext* Device::Create(const GraphicsContextDescription& description)
@@ -195,7 +313,57 @@ GraphicsContext* Device::Create(const GraphicsContextDescription& description)
 
 GraphicsPipeline* Device::Create(const GraphicsPipelineDescription& description)
 {
-	return Allocator->Create<GraphicsPipeline>(description, this);
+	if (WarmUpManifest)
+	{
+		WarmUpManifest->Record(description);
+	}
+
+	GraphicsPipeline* graphicsPipeline = GraphicsPipelineCache.Acquire(description);
+	if (graphicsPipeline)
+	{
+		WaitForPipeline(graphicsPipeline);
+		return graphicsPipeline;
+	}
+
+	graphicsPipeline = Allocator->Create<GraphicsPipeline>(description, this);
+	GraphicsPipelineCache.Add(description, graphicsPipeline);
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Add(graphicsPipeline);
+	}
+#endif
+	return graphicsPipeline;
+}
+
+GraphicsPipeline* Device::CreateAsync(const GraphicsPipelineDescription& description, PipelinePriority priority, GraphicsPipeline* fallback)
+{
+	if (!AsyncPipelineCompiler)
+	{
+		AsyncPipelineCompiler = Allocator->Create<PipelineCompiler>(this);
+	}
+	if (WarmUpManifest)
+	{
+		WarmUpManifest->Record(description);
+	}
+
+	// A shared pipeline keeps the priority and fallback it was first created with.
+	GraphicsPipeline* graphicsPipeline = GraphicsPipelineCache.Acquire(description);
+	if (graphicsPipeline)
+	{
+		return graphicsPipeline;
+	}
+
+	graphicsPipeline = Allocator->Create<GraphicsPipeline>(description, this, priority, fallback);
+	GraphicsPipelineCache.Add(description, graphicsPipeline);
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Add(graphicsPipeline);
+	}
+#endif
+	AsyncPipelineCompiler->Add(graphicsPipeline);
+	return graphicsPipeline;
 }
 
 Heap* Device::Create(const HeapDescription& description)
@@ -203,6 +371,16 @@ Heap* Device::Create(const HeapDescription& description)
 	return Allocator->Create<Heap>(description, this);
 }
 
+QueryPool* Device::Create(const QueryPoolDescription& description)
+{
+	return Allocator->Create<QueryPool>(description, this);
+}
+
+ReadbackRing* Device::Create(const ReadbackRingDescription& description)
+{
+	return Allocator->Create<ReadbackRing>(description, this);
+}
+
 Resource* Device::Create(const ResourceDescription& description)
 {
 	return Allocator->Create<Resource>(description, this);
@@ -210,17 +388,77 @@ Resource* Device::Create(const ResourceDescription& description)
 
 Sampler* Device::Create(const SamplerDescription& description)
 {
-	return Allocator->Create<Sampler>(description, this);
+	Sampler* sampler = SamplerCache.Acquire(description);
+	if (!sampler)
+	{
+		sampler = Allocator->Create<Sampler>(description, this);
+		SamplerCache.Add(description, sampler);
+	}
+	return sampler;
 }
 
 Shader* Device::Create(const ShaderDescription& description)
 {
-	return Allocator->Create<Shader>(description, this);
+	if (WarmUpManifest)
+	{
+		WarmUpManifest->Record(description);
+	}
+
+	Shader* shader = Allocator->Create<Shader>(description, this);
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Add(shader);
+	}
+#endif
+	return shader;
+}
+
+void Device::Create(ArrayView<const ShaderDescription> descriptions, Shader** shaders, String* errors)
+{
+	if (WarmUpManifest)
+	{
+		for (const ShaderDescription& description : descriptions)
+		{
+			WarmUpManifest->Record(description);
+		}
+	}
+
+	Array<DXC::CompileOutput> outputs(descriptions.GetLength(), Allocator);
+	for (usize i = 0; i < descriptions.GetLength(); ++i)
+	{
+		outputs.Add(DXC::CompileOutput
+		{
+			.Blob = nullptr,
+			.Reflection = {},
+			.Dependencies = Array<DXC::CacheDependency>(Allocator),
+		});
+	}
+
+	DXC::CompileBatch(descriptions, outputs.GetData(), errors);
+
+	for (usize i = 0; i < descriptions.GetLength(); ++i)
+	{
+		DXC::CompileOutput& output = outputs[i];
+		shaders[i] = output.Blob ? Allocator->Create<Shader>(descriptions[i], this, &output) : nullptr;
+#if !RELEASE
+		if (ShaderHotReload && shaders[i])
+		{
+			ShaderHotReload->Add(shaders[i]);
+		}
+#endif
+	}
 }
 
 TextureView* Device::Create(const TextureViewDescription& description)
 {
-	return Allocator->Create<TextureView>(description, this);
+	TextureView* textureView = TextureViewCache.Acquire(description);
+	if (!textureView)
+	{
+		textureView = Allocator->Create<TextureView>(description, this);
+		TextureViewCache.Add(description, textureView);
+	}
+	return textureView;
 }
 
 void Device::Destroy(AccelerationStructure* accelerationStructure) const
@@ -228,23 +466,52 @@ void Device::Destroy(AccelerationStructure* accelerationStructure) const
 	Allocator->Destroy(accelerationStructure);
 }
 
-void Device::Destroy(BufferView* bufferView) const
+void Device::Destroy(BufferView* bufferView)
 {
+	if (!BufferViewCache.Release(bufferView))
+	{
+		return;
+	}
 	Allocator->Destroy(bufferView);
 }
 
 void Device::Destroy(ComputePipeline* computePipeline) const
 {
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Remove(computePipeline);
+	}
+#endif
 	Allocator->Destroy(computePipeline);
 }
 
+void Device::Destroy(Fence* fence) const
+{
+	Allocator->Destroy(fence);
+}
+
 void Device::Destroy(GraphicsContext* graphicsContext) const
 {
 	Allocator->Destroy(graphicsContext);
 }
 
-void Device::Destroy(GraphicsPipeline* graphicsPipeline) const
+void Device::Destroy(GraphicsPipeline* graphicsPipeline)
 {
+	if (!GraphicsPipelineCache.Release(graphicsPipeline))
+	{
+		return;
+	}
+	if (AsyncPipelineCompiler)
+	{
+		AsyncPipelineCompiler->Remove(graphicsPipeline);
+	}
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Remove(graphicsPipeline);
+	}
+#endif
 	Allocator->Destroy(graphicsPipeline);
 }
 
@@ -253,71 +520,149 @@ void Device::Destroy(Heap* heap)
 	Allocator->Destroy(heap);
 }
 
+void Device::Destroy(QueryPool* queryPool) const
+{
+	Allocator->Destroy(queryPool);
+}
+
+void Device::Destroy(ReadbackRing* readbackRing) const
+{
+	Allocator->Destroy(readbackRing);
+}
+
 void Device::Destroy(Resource* resource) const
 {
 	Allocator->Destroy(resource);
 }
 
-void Device::Destroy(Sampler* sampler) const
+void Device::Destroy(Sampler* sampler)
 {
+	if (!SamplerCache.Release(sampler))
+	{
+		return;
+	}
 	Allocator->Destroy(sampler);
 }
 
 void Device::Destroy(Shader* shader) const
 {
+#if !RELEASE
+	if (ShaderHotReload)
+	{
+		ShaderHotReload->Remove(shader);
+	}
+#endif
 	Allocator->Destroy(shader);
 }
 
-void Device::Destroy(TextureView* textureView) const
+void Device::Destroy(TextureView* textureView)
 {
+	if (!TextureViewCache.Release(textureView))
+	{
+		return;
+	}
 	Allocator->Destroy(textureView);
 }
 
+void Device::ReleaseBytecode(Shader* shader) const
+{
+#if !RELEASE
+	// Hot reload rebuilds pipelines from the current bytecode, and a reload replaces it anyway.
+	if (ShaderHotReload)
+	{
+		return;
+	}
+#endif
+	SAFE_RELEASE(shader->Blob);
+}
+
 void Device::Write(Resource* write, const ResourceDescription& format, const void* data) const
 {
 	write->Write(format, data);
 }
 
+void Device::Write(Resource* write, usize offset, usize size, const void* data) const
+{
+	write->Write(offset, size, data);
+}
+
+void Device::Read(const Resource* read, usize offset, usize size, void* data) const
+{
+	read->Read(offset, size, data);
+}
+
 void Device::Submit(const GraphicsContext* context) const
 {
 	context->Execute(GraphicsQueue);
 }
 
+void Device::Signal(const Fence* fence, uint64 value) const
+{
+	fence->Signal(GraphicsQueue, value);
+}
+
+void Device::Wait(const Fence* fence, uint64 value) const
+{
+	fence->Wait(GraphicsQueue, value);
+}
+
 void Device::Present()
 {
 	const uint64 frameFenceValue = FrameFenceValues[GetFrameIndex()];
-	CHECK_RESULT(SwapChain->Present(1, 0));
+	if (SwapChain)
+	{
+		CHECK_RESULT(SwapChain->Present(1, 0));
+	}
+	else
+	{
+		FrameIndex = (FrameIndex + 1) % FramesInFlight;
+	}
 
-	CHECK_RESULT(GraphicsQueue->Signal(FrameFence, frameFenceValue));
+	FrameFence->Signal(GraphicsQueue, frameFenceValue);
+	++FrameCount;
 
-	if (FrameFence->GetCompletedValue() < FrameFenceValues[GetFrameIndex()])
+#if !RELEASE
+	if (ShaderHotReload)
 	{
-		CHECK_RESULT(FrameFence->SetEventOnCompletion(FrameFenceValues[GetFrameIndex()], nullptr));
-		WaitForSingleObjectEx(nullptr, INFINITE, false);
+		ShaderHotReload->Apply(frameFenceValue, FrameFence->GetCompletedValue());
 	}
+#endif
+
+	FrameFence->WaitFor(FrameFenceValues[GetFrameIndex()], InfiniteTimeout);
+	MostRecentFrameWaitTime = FrameFence->MostRecentWaitTime;
 	FrameFenceValues[GetFrameIndex()] = frameFenceValue + 1;
 }
 
 void Device::WaitForIdle()
 {
 	const uint64 fenceValue = FrameFenceValues[GetFrameIndex()];
-	CHECK_RESULT(GraphicsQueue->Signal(FrameFence, fenceValue));
+	FrameFence->Signal(GraphicsQueue, fenceValue);
 
-	if (FrameFence->GetCompletedValue() < fenceValue)
+	FrameFence->WaitFor(fenceValue, InfiniteTimeout);
+	MostRecentFrameWaitTime = FrameFence->MostRecentWaitTime;
+	++FrameFenceValues[GetFrameIndex()];
+}
+
+void Device::WaitForFrameLatency() const
+{
+	if (!FrameLatencyWaitable)
 	{
-		CHECK_RESULT(FrameFence->SetEventOnCompletion(fenceValue, nullptr));
-		WaitForSingleObjectEx(nullptr, INFINITE, false);
+		return;
 	}
-	++FrameFenceValues[GetFrameIndex()];
+
+	static constexpr uint32 frameLatencyTimeoutMilliseconds = 1000;
+	WaitForSingleObjectEx(FrameLatencyWaitable, frameLatencyTimeoutMilliseconds, true);
 }
 
 void Device::ResizeSwapChain(uint32 width, uint32 height)
 {
-	CHECK_RESULT(SwapChain->ResizeBuffers(FramesInFlight, width, height, DXGI_FORMAT_UNKNOWN, 0));
+	CHECK(SwapChain);
 
-	for (uint64& frameFenceValue : FrameFenceValues)
+	CHECK_RESULT(SwapChain->ResizeBuffers(static_cast<uint32>(FramesInFlight), width, height, DXGI_FORMAT_UNKNOWN, SwapChainFlags));
+
+	for (usize frameIndex = 0; frameIndex < FramesInFlight; ++frameIndex)
 	{
-		frameFenceValue = GetFrameIndex();
+		FrameFenceValues[frameIndex] = GetFrameIndex();
 	}
 
 	RenderTargetViewHeap.Reset();
@@ -326,7 +671,12 @@ void Device::ResizeSwapChain(uint32 width, uint32 height)
 
 usize Device::GetFrameIndex() const
 {
-	return SwapChain->GetCurrentBackBufferIndex();
+	return SwapChain ? SwapChain->GetCurrentBackBufferIndex() : FrameIndex;
+}
+
+bool Device::IsHeadless() const
+{
+	return SwapChain == nullptr;
 }
 
 usize Device::GetResourceSize(const ResourceDescription& description) const
@@ -375,6 +725,94 @@ usize Device::GetAccelerationStructureInstanceSize()
 	return sizeof(D3D12_RAYTRACING_INSTANCE_DESC);
 }
 
+ShaderCacheStatistics Device::GetShaderCacheStatistics() const
+{
+	return DXC::GetCacheStatistics();
+}
+
+ShaderArchiveStatistics Device::GetShaderArchiveStatistics() const
+{
+	return DXC::GetArchiveStatistics();
+}
+
+void Device::CreatePipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState)
+{
+	PipelineCache->Create(description, pipelineState);
+}
+
+void Device::CreatePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState)
+{
+	PipelineCache->Create(description, pipelineState);
+}
+
+void Device::CreateRootSignature(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& description, ID3D12RootSignature** rootSignature)
+{
+	RootSignatures->Create(description, rootSignature);
+}
+
+void Device::SavePipelineCache()
+{
+	PipelineCache->Save();
+}
+
+void Device::WaitForPipeline(GraphicsPipeline* graphicsPipeline) const
+{
+	if (!graphicsPipeline->IsReady())
+	{
+		AsyncPipelineCompiler->Wait(graphicsPipeline);
+	}
+}
+
+void Device::WarmUpPipelines()
+{
+	if (!WarmUpManifest)
+	{
+		return;
+	}
+
+	LARGE_INTEGER start;
+	QueryPerformanceCounter(&start);
+
+	PipelineCache->BeginPrewarm();
+	WarmUpManifest->Replay(this);
+	PipelineCache->EndPrewarm();
+
+	LARGE_INTEGER end;
+	QueryPerformanceCounter(&end);
+	WarmUpTime += static_cast<double>(end.QuadPart - start.QuadPart) / PerformanceCounterFrequency;
+}
+
+PipelineWarmUpStatistics Device::GetPipelineWarmUpStatistics() const
+{
+	PipelineWarmUpStatistics statistics =
+	{
+		.Recorded = WarmUpManifest ? WarmUpManifest->Recorded.GetCount() : 0,
+		.Prewarmed = 0,
+		.PrewarmedUsed = 0,
+		.Late = 0,
+		.WarmUpTime = WarmUpTime,
+	};
+	PipelineCache->GetWarmUpStatistics(&statistics);
+	return statistics;
+}
+
+ObjectCacheStatistics Device::GetObjectCacheStatistics() const
+{
+	// Texture views are counted at the shader-visible descriptor size, though render target and depth views are smaller.
+	return ObjectCacheStatistics
+	{
+		.Samplers = SamplerCache.GetCounters(SamplerViewHeap.ViewSize),
+		.TextureViews = TextureViewCache.GetCounters(ConstantBufferShaderResourceUnorderedAccessViewHeap.ViewSize),
+		.BufferViews = BufferViewCache.GetCounters(ConstantBufferShaderResourceUnorderedAccessViewHeap.ViewSize),
+		.GraphicsPipelines = GraphicsPipelineCache.GetCounters(0),
+	};
+}
+
+PipelineCacheStatistics Device::GetPipelineCacheStatistics() const
+{
+	return PipelineCache->GetStatistics();
+}
+
 D3D12_CPU_DESCRIPTOR_HANDLE Device::GetCpu(usize index, ViewType type) const
 {
 	switch (type)
@@ -415,6 +853,8 @@ D3D12_GPU_DESCRIPTOR_HANDLE Device::GetGpu(usize index, ViewType type) const
 
 ID3D12Resource2* Device::GetSwapChainResource(usize backBufferIndex) const
 {
+	CHECK(SwapChain);
+
 	ID3D12Resource2* resource = nullptr;
 	CHECK_RESULT(SwapChain->GetBuffer(static_cast<uint32>(backBufferIndex), IID_PPV_ARGS(&resource)));
 	return resource;
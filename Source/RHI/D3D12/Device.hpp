@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Base.hpp"
+#include "BufferView.hpp"
+#include "GraphicsPipeline.hpp"
+#include "ObjectCache.hpp"
+#include "Sampler.hpp"
+#include "TextureView.hpp"
 #include "ViewHeap.hpp"
 
 #include "RHI/RHI.hpp"
@@ -11,40 +16,56 @@ namespace RHI::D3D12
 class Device : public NoCopy
 {
 public:
-	explicit Device(const Platform::Window* window);
+	explicit Device(const DeviceDescription& description);
 	~Device();
 
 	AccelerationStructure* Create(const AccelerationStructureDescription& description);
 	BufferView* Create(const BufferViewDescription& description);
 	ComputePipeline* Create(const ComputePipelineDescription& description);
+	Fence* Create(const FenceDescription& description);
 	GraphicsContext* Create(const GraphicsContextDescription& description);
 	GraphicsPipeline* Create(const GraphicsPipelineDescription& description);
+	GraphicsPipeline* CreateAsync(const GraphicsPipelineDescription& description, PipelinePriority priority, GraphicsPipeline* fallback);
 	Heap* Create(const HeapDescription& description);
+	QueryPool* Create(const QueryPoolDescription& description);
+	ReadbackRing* Create(const ReadbackRingDescription& description);
 	Resource* Create(const ResourceDescription& description);
 	Sampler* Create(const SamplerDescription& description);
 	Shader* Create(const ShaderDescription& description);
+	void Create(ArrayView<const ShaderDescription> descriptions, Shader** shaders, String* errors);
 	TextureView* Create(const TextureViewDescription& description);
 
 	void Destroy(AccelerationStructure* accelerationStructure) const;
-	void Destroy(BufferView* bufferView) const;
+	void Destroy(BufferView* bufferView);
 	void Destroy(ComputePipeline* computePipeline) const;
+	void Destroy(Fence* fence) const;
 	void Destroy(GraphicsContext* graphicsContext) const;
-	void Destroy(GraphicsPipeline* graphicsPipeline) const;
+	void Destroy(GraphicsPipeline* graphicsPipeline);
 	void Destroy(Heap* heap);
+	void Destroy(QueryPool* queryPool) const;
+	void Destroy(ReadbackRing* readbackRing) const;
 	void Destroy(Resource* resource) const;
-	void Destroy(Sampler* sampler) const;
+	void Destroy(Sampler* sampler);
 	void Destroy(Shader* shader) const;
-	void Destroy(TextureView* textureView) const;
+	void Destroy(TextureView* textureView);
+
+	void ReleaseBytecode(Shader* shader) const;
 
 	void Write(Resource* write, const ResourceDescription& format, const void* data) const;
+	void Write(Resource* write, usize offset, usize size, const void* data) const;
+	void Read(const Resource* read, usize offset, usize size, void* data) const;
 
 	void Submit(const GraphicsContext* context) const;
+	void Signal(const Fence* fence, uint64 value) const;
+	void Wait(const Fence* fence, uint64 value) const;
 	void Present();
 	void WaitForIdle();
+	void WaitForFrameLatency() const;
 
 	void ResizeSwapChain(uint32 width, uint32 height);
 
 	usize GetFrameIndex() const;
+	bool IsHeadless() const;
 
 	usize GetResourceSize(const ResourceDescription& description) const;
 	usize GetResourceAlignment(const ResourceDescription& description) const;
@@ -53,25 +74,71 @@ public:
 	AccelerationStructureSize GetAccelerationStructureSize(const Buffer& instances) const;
 	usize GetAccelerationStructureInstanceSize();
 
+	ShaderCacheStatistics GetShaderCacheStatistics() const;
+	ShaderArchiveStatistics GetShaderArchiveStatistics() const;
+
+	void CreatePipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState);
+	void CreatePipelineState(const D3D12_COMPUTE_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState);
+	void CreateRootSignature(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& description, ID3D12RootSignature** rootSignature);
+	void SavePipelineCache();
+	void WaitForPipeline(GraphicsPipeline* graphicsPipeline) const;
+
+	void WarmUpPipelines();
+	PipelineWarmUpStatistics GetPipelineWarmUpStatistics() const;
+	PipelineCacheStatistics GetPipelineCacheStatistics() const;
+	ObjectCacheStatistics GetObjectCacheStatistics() const;
+
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCpu(usize index, ViewType type) const;
 	D3D12_GPU_DESCRIPTOR_HANDLE GetGpu(usize index, ViewType type) const;
 
 	ID3D12Resource2* GetSwapChainResource(usize backBufferIndex) const;
 
+	void CreateSwapChain(IDXGIFactory7* dxgiFactory, const Platform::Window* window);
+
 	ID3D12Device11* Native;
 	IDXGISwapChain4* SwapChain;
 
 	ID3D12CommandQueue* GraphicsQueue;
 
-	ID3D12Fence1* FrameFence;
-	uint64 FrameFenceValues[FramesInFlight];
+	usize FramesInFlight;
+	usize FrameIndex;
+	uint64 FrameCount;
+
+	Fence* FrameFence;
+	uint64 FrameFenceValues[MaxFramesInFlight];
+
+	HANDLE FrameLatencyWaitable;
 
 	ViewHeap ConstantBufferShaderResourceUnorderedAccessViewHeap;
+
+	// ClearUnorderedAccessView* needs the view's descriptor in a heap that is not shader visible as well, so every
+	// unordered access view is written here too, at its own heap index.
+	ViewHeap UnorderedAccessClearViewHeap;
+
 	ViewHeap RenderTargetViewHeap;
 	ViewHeap DepthStencilViewHeap;
 	ViewHeap SamplerViewHeap;
 
 	double TimeStampFrequency;
+	double PerformanceCounterFrequency;
+
+	double MostRecentFrameWaitTime;
+
+	RootSignatureCache* RootSignatures;
+	PipelineLibrary* PipelineCache;
+	PipelineCompiler* AsyncPipelineCompiler;
+
+	PipelineManifest* WarmUpManifest;
+	double WarmUpTime;
+
+	ObjectCache<Sampler, SamplerDescription> SamplerCache;
+	ObjectCache<TextureView, TextureViewDescription> TextureViewCache;
+	ObjectCache<BufferView, BufferViewDescription> BufferViewCache;
+	ObjectCache<GraphicsPipeline, GraphicsPipelineDescription> GraphicsPipelineCache;
+
+#if !RELEASE
+	HotReload* ShaderHotReload;
+#endif
 };
 
 }
@@ -0,0 +1,68 @@
+#include "Fence.hpp"
+#include "Device.hpp"
+
+namespace RHI::D3D12
+{
+
+Fence::Fence(const FenceDescription& description, const D3D12::Device* device)
+	: FenceDescription(description)
+	, Device(device)
+	, MostRecentWaitTime(0.0)
+{
+	CHECK_RESULT(Device->Native->CreateFence(InitialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Native)));
+	SET_D3D_NAME(Native, Name);
+
+	Event = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+	CHECK(Event);
+}
+
+Fence::~Fence()
+{
+	CloseHandle(Event);
+	Event = nullptr;
+	SAFE_RELEASE(Native);
+}
+
+void Fence::Signal(ID3D12CommandQueue* queue, uint64 value) const
+{
+	CHECK_RESULT(queue->Signal(Native, value));
+}
+
+void Fence::Wait(ID3D12CommandQueue* queue, uint64 value) const
+{
+	CHECK_RESULT(queue->Wait(Native, value));
+}
+
+uint64 Fence::GetCompletedValue() const
+{
+	return Native->GetCompletedValue();
+}
+
+bool Fence::WaitFor(uint64 value, uint32 timeoutMilliseconds)
+{
+	if (Native->GetCompletedValue() >= value)
+	{
+		MostRecentWaitTime = 0.0;
+		return true;
+	}
+
+	LARGE_INTEGER waitStart;
+	QueryPerformanceCounter(&waitStart);
+
+	while (Native->GetCompletedValue() < value)
+	{
+		CHECK_RESULT(Native->SetEventOnCompletion(value, Event));
+		if (WaitForSingleObjectEx(Event, timeoutMilliseconds, false) == WAIT_TIMEOUT)
+		{
+			break;
+		}
+	}
+
+	LARGE_INTEGER waitEnd;
+	QueryPerformanceCounter(&waitEnd);
+	MostRecentWaitTime = static_cast<double>(waitEnd.QuadPart - waitStart.QuadPart) / Device->PerformanceCounterFrequency;
+
+	return Native->GetCompletedValue() >= value;
+}
+
+}
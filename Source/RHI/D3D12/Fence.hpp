@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Fence.hpp"
+
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+class Fence final : public FenceDescription, NoCopy
+{
+public:
+	Fence(const FenceDescription& description, const Device* device);
+	~Fence();
+
+	void Signal(ID3D12CommandQueue* queue, uint64 value) const;
+	void Wait(ID3D12CommandQueue* queue, uint64 value) const;
+
+	uint64 GetCompletedValue() const;
+	bool WaitFor(uint64 value, uint32 timeoutMilliseconds);
+
+	ID3D12Fence1* Native;
+	HANDLE Event;
+	const Device* Device;
+
+	double MostRecentWaitTime;
+};
+
+}
@@ -13,7 +13,7 @@ struct ID3D12PipelineState;
 struct ID3D12QueryHeap;
 struct ID3D12Resource2;
 struct ID3D12RootSignature;
-struct ID3D12ShaderReflection;
+struct IDXGIFactory7;
 struct IDXGISwapChain4;
 struct IDxcBlob;
 struct IUnknown;
@@ -24,11 +24,19 @@ class AccelerationStructure;
 class BufferView;
 class ComputePipeline;
 class Device;
+class Fence;
 class GraphicsContext;
 class GraphicsPipeline;
 class Heap;
+class HotReload;
 class Pipeline;
+class PipelineCompiler;
+class PipelineLibrary;
+class PipelineManifest;
+class QueryPool;
+class ReadbackRing;
 class Resource;
+class RootSignatureCache;
 class Sampler;
 class Shader;
 class TextureView;
@@ -1,10 +1,13 @@
 #include "GraphicsContext.hpp"
 #include "Base.hpp"
+#include "BufferView.hpp"
 #include "ComputePipeline.hpp"
 #include "Convert.hpp"
 #include "Device.hpp"
 #include "GraphicsPipeline.hpp"
 #include "Pipeline.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 #include "Resource.hpp"
 #include "TextureView.hpp"
 
@@ -15,14 +18,22 @@ static constexpr usize FrameTimeQueryCount = 2;
 
 GraphicsContext::GraphicsContext(const GraphicsContextDescription& description, D3D12::Device* device)
 	: GraphicsContextDescription(description)
+	, CommandAllocators()
 	, CurrentPipeline(nullptr)
+	, CurrentGraphicsRootSignature(nullptr)
+	, CurrentComputeRootSignature(nullptr)
+	, CurrentPrimitiveTopology(PrimitiveTopology::TriangleList)
 	, Device(device)
+#if DEBUG
+	, PendingSplitBarriers()
+	, PendingSplitBarrierCount(0)
+#endif
 	, MostRecentGpuTime(0.0)
 {
 	static constexpr D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT;
-	for (ID3D12CommandAllocator*& allocator : CommandAllocators)
+	for (usize frameIndex = 0; frameIndex < Device->FramesInFlight; ++frameIndex)
 	{
-		CHECK_RESULT(Device->Native->CreateCommandAllocator(type, IID_PPV_ARGS(&allocator)));
+		CHECK_RESULT(Device->Native->CreateCommandAllocator(type, IID_PPV_ARGS(&CommandAllocators[frameIndex])));
 	}
 	CHECK_RESULT(Device->Native->CreateCommandList1(0, type, D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS(&Native)));
 
@@ -43,9 +54,10 @@ GraphicsContext::GraphicsContext(const GraphicsContextDescription& description,
 		.Format = ResourceFormat::None,
 		.Flags = ResourceFlags::ReadBack,
 		.InitialLayout = BarrierLayout::Undefined,
-		.Size = (FramesInFlight + 1) * FrameTimeQueryCount * sizeof(uint64),
+		.Size = (Device->FramesInFlight + 1) * FrameTimeQueryCount * sizeof(uint64),
 		.Name = "Frame Time Query Resource"_view,
 	});
+	FrameTimeResolveIndex = 0;
 #endif
 }
 
@@ -67,7 +79,7 @@ GraphicsContext::~GraphicsContext()
 	CurrentPipeline = nullptr;
 }
 
-void GraphicsContext::Begin() const
+void GraphicsContext::Begin()
 {
 	const usize backBufferIndex = Device->GetFrameIndex();
 
@@ -85,18 +97,30 @@ void GraphicsContext::Begin() const
 	};
 	Native->SetDescriptorHeaps(ARRAY_COUNT(heaps), heaps);
 
-	Native->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	Native->IASetPrimitiveTopology(To(PrimitiveTopology::TriangleList));
+
+	CurrentPipeline = nullptr;
+	CurrentGraphicsRootSignature = nullptr;
+	CurrentComputeRootSignature = nullptr;
+	CurrentPrimitiveTopology = PrimitiveTopology::TriangleList;
+
+#if DEBUG
+	PendingSplitBarrierCount = 0;
+#endif
 }
 
 void GraphicsContext::End()
 {
+#if DEBUG
+	VERIFY(PendingSplitBarrierCount == 0, "A split barrier was begun but never ended on this context!");
+#endif
+
 #if !RELEASE
 	ID3D12Resource2* frameTimeQueryResourceNative = FrameTimeQueryResource->Native;
 
 	Native->EndQuery(FrameTimeQueryHeap, D3D12_QUERY_TYPE_TIMESTAMP, 1);
 
-	static uint32 currentFrameResolveIndex = 0;
-	const uint64 currentFrameResolveOffset = currentFrameResolveIndex * FrameTimeQueryCount * sizeof(uint64);
+	const uint64 currentFrameResolveOffset = FrameTimeResolveIndex * FrameTimeQueryCount * sizeof(uint64);
 	Native->ResolveQueryData(FrameTimeQueryHeap,
 							 D3D12_QUERY_TYPE_TIMESTAMP,
 							 0,
@@ -108,9 +132,9 @@ void GraphicsContext::End()
 	CHECK_RESULT(Native->Close());
 
 #if !RELEASE
-	const uint32 readbackFrameIndex = (currentFrameResolveIndex + 1) % (FramesInFlight + 1);
+	const usize readbackFrameIndex = (FrameTimeResolveIndex + 1) % (Device->FramesInFlight + 1);
 	const usize readbackOffset = readbackFrameIndex * FrameTimeQueryCount * sizeof(uint64);
-	currentFrameResolveIndex = readbackFrameIndex;
+	FrameTimeResolveIndex = readbackFrameIndex;
 
 	const D3D12_RANGE dataRange =
 	{
@@ -210,31 +234,105 @@ void GraphicsContext::ClearDepthStencil(const TextureView* depthStencil) const
 	Native->ClearDepthStencilView(cpu, clearFlags, depthStencil->Resource.DepthClear, 0, 0, nullptr);
 }
 
+void GraphicsContext::ClearUnorderedAccess(const BufferView* buffer, uint32 value) const
+{
+	const uint32 values[4] = { value, value, value, value };
+	Native->ClearUnorderedAccessViewUint(buffer->GetGpu(),
+										 buffer->GetClearCpu(),
+										 buffer->Buffer.Resource.Backend->Native,
+										 values,
+										 0,
+										 nullptr);
+}
+
+void GraphicsContext::ClearUnorderedAccess(const TextureView* texture, const Float4& value) const
+{
+	Native->ClearUnorderedAccessViewFloat(texture->GetGpu(),
+										  texture->GetClearCpu(),
+										  texture->Resource.Backend->Native,
+										  reinterpret_cast<const float*>(&value),
+										  0,
+										  nullptr);
+}
+
+void GraphicsContext::ClearUnorderedAccess(const TextureView* texture, uint32 value) const
+{
+	const uint32 values[4] = { value, value, value, value };
+	Native->ClearUnorderedAccessViewUint(texture->GetGpu(),
+										 texture->GetClearCpu(),
+										 texture->Resource.Backend->Native,
+										 values,
+										 0,
+										 nullptr);
+}
+
 void GraphicsContext::SetPipeline(GraphicsPipeline* pipeline)
 {
-	Native->SetGraphicsRootSignature(pipeline->RootSignature);
+	if (!pipeline->IsReady())
+	{
+		if (pipeline->Fallback)
+		{
+			pipeline = pipeline->Fallback;
+		}
+		else
+		{
+			Device->WaitForPipeline(pipeline);
+		}
+	}
+
+	if (pipeline->RootSignature != CurrentGraphicsRootSignature)
+	{
+		Native->SetGraphicsRootSignature(pipeline->RootSignature);
+		CurrentGraphicsRootSignature = pipeline->RootSignature;
+	}
+	if (pipeline->PrimitiveTopology != CurrentPrimitiveTopology)
+	{
+		Native->IASetPrimitiveTopology(To(pipeline->PrimitiveTopology));
+		CurrentPrimitiveTopology = pipeline->PrimitiveTopology;
+	}
 	Native->SetPipelineState(pipeline->PipelineState);
 	CurrentPipeline = pipeline;
 }
 
 void GraphicsContext::SetPipeline(ComputePipeline* pipeline)
 {
-	Native->SetComputeRootSignature(pipeline->RootSignature);
+	if (pipeline->RootSignature != CurrentComputeRootSignature)
+	{
+		Native->SetComputeRootSignature(pipeline->RootSignature);
+		CurrentComputeRootSignature = pipeline->RootSignature;
+	}
 	Native->SetPipelineState(pipeline->PipelineState);
 	CurrentPipeline = pipeline;
 }
 
-void GraphicsContext::SetVertexBuffer(usize slot, const SubBuffer& vertexBuffer) const
+static D3D12_VERTEX_BUFFER_VIEW ToVertexBufferView(const SubBuffer& vertexBuffer)
 {
-	const D3D12_VERTEX_BUFFER_VIEW view =
+	return D3D12_VERTEX_BUFFER_VIEW
 	{
 		.BufferLocation = vertexBuffer.Resource.Backend->Native->GetGPUVirtualAddress() + vertexBuffer.Offset,
 		.SizeInBytes = static_cast<uint32>(vertexBuffer.Size),
 		.StrideInBytes = static_cast<uint32>(vertexBuffer.Stride),
 	};
+}
+
+void GraphicsContext::SetVertexBuffer(usize slot, const SubBuffer& vertexBuffer) const
+{
+	const D3D12_VERTEX_BUFFER_VIEW view = ToVertexBufferView(vertexBuffer);
 	Native->IASetVertexBuffers(static_cast<uint32>(slot), 1, &view);
 }
 
+void GraphicsContext::SetVertexBuffers(usize startSlot, const ArrayView<const SubBuffer>& vertexBuffers) const
+{
+	CHECK(startSlot + vertexBuffers.GetLength() <= D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+	D3D12_VERTEX_BUFFER_VIEW views[D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+	for (usize i = 0; i < vertexBuffers.GetLength(); ++i)
+	{
+		views[i] = ToVertexBufferView(vertexBuffers[i]);
+	}
+	Native->IASetVertexBuffers(static_cast<uint32>(startSlot), static_cast<uint32>(vertexBuffers.GetLength()), views);
+}
+
 void GraphicsContext::SetIndexBuffer(const SubBuffer& indexBuffer) const
 {
 	CHECK(indexBuffer.Stride == sizeof(uint16) || indexBuffer.Stride == sizeof(uint32));
@@ -253,6 +351,18 @@ void GraphicsContext::SetConstantBuffer(StringView name, const Resource* buffer,
 	CurrentPipeline->SetConstantBuffer(Native, name, buffer, offset);
 }
 
+void GraphicsContext::SetShaderResource(StringView name, const Resource* buffer, usize offset) const
+{
+	CHECK(CurrentPipeline);
+	CurrentPipeline->SetShaderResource(Native, name, buffer, offset);
+}
+
+void GraphicsContext::SetUnorderedAccess(StringView name, const Resource* buffer, usize offset) const
+{
+	CHECK(CurrentPipeline);
+	CurrentPipeline->SetUnorderedAccess(Native, name, buffer, offset);
+}
+
 void GraphicsContext::SetRootConstants(const void* data) const
 {
 	CHECK(CurrentPipeline);
@@ -264,9 +374,9 @@ void GraphicsContext::Draw(usize vertexCount) const
 	Native->DrawInstanced(static_cast<uint32>(vertexCount), 1, 0, 0);
 }
 
-void GraphicsContext::DrawIndexed(usize indexCount) const
+void GraphicsContext::DrawIndexed(usize indexCount, usize firstIndex, int32 baseVertex) const
 {
-	Native->DrawIndexedInstanced(static_cast<uint32>(indexCount), 1, 0, 0, 0);
+	Native->DrawIndexedInstanced(static_cast<uint32>(indexCount), 1, static_cast<uint32>(firstIndex), baseVertex, 0);
 }
 
 void GraphicsContext::Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ) const
@@ -279,6 +389,138 @@ void GraphicsContext::Copy(const Resource* destination, const Resource* source)
 	destination->Copy(Native, source->Native);
 }
 
+void GraphicsContext::CopyBufferRegion(const Resource* destination,
+									   usize destinationOffset,
+									   const Resource* source,
+									   usize sourceOffset,
+									   usize size) const
+{
+	CHECK(destination->Type == ResourceType::Buffer && source->Type == ResourceType::Buffer);
+	CHECK(destinationOffset + size <= destination->Size && sourceOffset + size <= source->Size);
+
+	Native->CopyBufferRegion(destination->Native, destinationOffset, source->Native, sourceOffset, size);
+}
+
+void GraphicsContext::CopyTextureRegion(const Resource* destination,
+										uint32 destinationMipLevel,
+										uint32 destinationX,
+										uint32 destinationY,
+										const Resource* source,
+										const TextureRegion& sourceRegion) const
+{
+	CHECK(destination->Type == ResourceType::Texture2D && source->Type == ResourceType::Texture2D);
+	CHECK(sourceRegion.Width > 0 && sourceRegion.Height > 0);
+
+	const D3D12_TEXTURE_COPY_LOCATION destinationLocation =
+	{
+		.pResource = destination->Native,
+		.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+		.SubresourceIndex = destinationMipLevel,
+	};
+	const D3D12_TEXTURE_COPY_LOCATION sourceLocation =
+	{
+		.pResource = source->Native,
+		.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+		.SubresourceIndex = sourceRegion.MipLevel,
+	};
+	const D3D12_BOX sourceBox =
+	{
+		.left = sourceRegion.X,
+		.top = sourceRegion.Y,
+		.front = 0,
+		.right = sourceRegion.X + sourceRegion.Width,
+		.bottom = sourceRegion.Y + sourceRegion.Height,
+		.back = 1,
+	};
+	Native->CopyTextureRegion(&destinationLocation, destinationX, destinationY, 0, &sourceLocation, &sourceBox);
+}
+
+ReadbackTicket GraphicsContext::EnqueueReadback(ReadbackRing* readbackRing, const SubBuffer& source) const
+{
+	CHECK(source.Resource.IsValid());
+
+	const ReadbackTicket ticket = readbackRing->Allocate(source.Size, sizeof(uint64));
+	Native->CopyBufferRegion(readbackRing->Buffer->Native, ticket.Offset, source.Resource.Backend->Native, source.Offset, source.Size);
+	return ticket;
+}
+
+ReadbackTicket GraphicsContext::EnqueueReadback(ReadbackRing* readbackRing, const Resource* texture, uint32 mipLevel) const
+{
+	CHECK(texture->Type == ResourceType::Texture2D);
+	CHECK(mipLevel < (texture->MipMapCount != 0 ? texture->MipMapCount : static_cast<uint16>(1)));
+
+	const D3D12_RESOURCE_DESC1 nativeDescription = To(*texture);
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout = {};
+	uint32 rowCount = 0;
+	uint64 rowSize = 0;
+	uint64 totalSize = 0;
+	Device->Native->GetCopyableFootprints1(&nativeDescription, mipLevel, 1, 0, &layout, &rowCount, &rowSize, &totalSize);
+
+	ReadbackTicket ticket = readbackRing->Allocate(totalSize, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	ticket.RowPitch = layout.Footprint.RowPitch;
+	ticket.RowSize = static_cast<uint32>(rowSize);
+	ticket.RowCount = rowCount;
+
+	layout.Offset = ticket.Offset;
+	const D3D12_TEXTURE_COPY_LOCATION sourceLocation =
+	{
+		.pResource = texture->Native,
+		.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+		.SubresourceIndex = mipLevel,
+	};
+	const D3D12_TEXTURE_COPY_LOCATION destinationLocation =
+	{
+		.pResource = readbackRing->Buffer->Native,
+		.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+		.PlacedFootprint = layout,
+	};
+	Native->CopyTextureRegion(&destinationLocation, 0, 0, 0, &sourceLocation, nullptr);
+
+	return ticket;
+}
+
+void GraphicsContext::BeginQuery(const QueryPool* queryPool, usize index) const
+{
+	CHECK(index < queryPool->Count);
+	Native->BeginQuery(queryPool->Native, To(queryPool->Type), static_cast<uint32>(index));
+}
+
+void GraphicsContext::EndQuery(const QueryPool* queryPool, usize index) const
+{
+	CHECK(index < queryPool->Count);
+	Native->EndQuery(queryPool->Native, To(queryPool->Type), static_cast<uint32>(index));
+}
+
+void GraphicsContext::ResolveQueryData(const QueryPool* queryPool, usize firstIndex, usize count, const Resource* destination, usize offset) const
+{
+	CHECK(firstIndex + count <= queryPool->Count);
+	CHECK(destination->Type == ResourceType::Buffer);
+	CHECK(offset % sizeof(uint64) == 0);
+	CHECK(offset + count * QueryResultSize <= destination->Size);
+
+	Native->ResolveQueryData(queryPool->Native,
+							 To(queryPool->Type),
+							 static_cast<uint32>(firstIndex),
+							 static_cast<uint32>(count),
+							 destination->Native,
+							 offset);
+}
+
+void GraphicsContext::SetPredication(const Resource* buffer, usize offset, PredicationOperation operation) const
+{
+	CHECK(buffer->Type == ResourceType::Buffer);
+	CHECK(offset % sizeof(uint64) == 0);
+	CHECK(offset + QueryResultSize <= buffer->Size);
+
+	Native->SetPredication(buffer->Native, offset, To(operation));
+}
+
+void GraphicsContext::ClearPredication() const
+{
+	Native->SetPredication(nullptr, 0, D3D12_PREDICATION_OP_EQUAL_ZERO);
+}
+
 void GraphicsContext::GlobalBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access) const
 {
 	const D3D12_GLOBAL_BARRIER globalBarrier =
@@ -321,18 +563,10 @@ void GraphicsContext::BufferBarrier(BarrierPair<BarrierStage> stage, BarrierPair
 void GraphicsContext::TextureBarrier(BarrierPair<BarrierStage> stage,
 									 BarrierPair<BarrierAccess> access,
 									 BarrierPair<BarrierLayout> layout,
-									 const Resource* texture) const
+									 const Resource* texture,
+									 const BarrierSubresourceRange& subresources) const
 {
 	static constexpr D3D12_TEXTURE_BARRIER_FLAGS noDiscard = D3D12_TEXTURE_BARRIER_FLAG_NONE;
-	static constexpr D3D12_BARRIER_SUBRESOURCE_RANGE entireRange =
-	{
-		.IndexOrFirstMipLevel = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES,
-		.NumMipLevels = 0,
-		.FirstArraySlice = 0,
-		.NumArraySlices = 0,
-		.FirstPlane = 0,
-		.NumPlanes = 0,
-	};
 	const D3D12_TEXTURE_BARRIER textureBarrier =
 	{
 		.SyncBefore = To(stage.Before),
@@ -342,7 +576,7 @@ void GraphicsContext::TextureBarrier(BarrierPair<BarrierStage> stage,
 		.LayoutBefore = To(layout.Before),
 		.LayoutAfter = To(layout.After),
 		.pResource = texture->Native,
-		.Subresources = entireRange,
+		.Subresources = To(subresources, *texture),
 		.Flags = noDiscard,
 	};
 	const D3D12_BARRIER_GROUP barrierGroup =
@@ -354,6 +588,89 @@ void GraphicsContext::TextureBarrier(BarrierPair<BarrierStage> stage,
 	Native->Barrier(1, &barrierGroup);
 }
 
+void GraphicsContext::BeginBufferBarrier(BarrierStage stageBefore, BarrierPair<BarrierAccess> access, const Resource* buffer)
+{
+#if DEBUG
+	BeginSplitBarrier(PendingSplitBarrier { .Resource = buffer->Native, .Access = access });
+#endif
+	BufferBarrier({ stageBefore, BarrierStage::Split }, access, buffer);
+}
+
+void GraphicsContext::EndBufferBarrier(BarrierStage stageAfter, BarrierPair<BarrierAccess> access, const Resource* buffer)
+{
+#if DEBUG
+	EndSplitBarrier(PendingSplitBarrier { .Resource = buffer->Native, .Access = access });
+#endif
+	BufferBarrier({ BarrierStage::Split, stageAfter }, access, buffer);
+}
+
+void GraphicsContext::BeginTextureBarrier(BarrierStage stageBefore,
+										  BarrierPair<BarrierAccess> access,
+										  BarrierPair<BarrierLayout> layout,
+										  const Resource* texture,
+										  const BarrierSubresourceRange& subresources)
+{
+#if DEBUG
+	BeginSplitBarrier(PendingSplitBarrier
+	{
+		.Resource = texture->Native,
+		.Access = access,
+		.Layout = layout,
+		.Subresources = subresources,
+	});
+#endif
+	TextureBarrier({ stageBefore, BarrierStage::Split }, access, layout, texture, subresources);
+}
+
+void GraphicsContext::EndTextureBarrier(BarrierStage stageAfter,
+										BarrierPair<BarrierAccess> access,
+										BarrierPair<BarrierLayout> layout,
+										const Resource* texture,
+										const BarrierSubresourceRange& subresources)
+{
+#if DEBUG
+	EndSplitBarrier(PendingSplitBarrier
+	{
+		.Resource = texture->Native,
+		.Access = access,
+		.Layout = layout,
+		.Subresources = subresources,
+	});
+#endif
+	TextureBarrier({ BarrierStage::Split, stageAfter }, access, layout, texture, subresources);
+}
+
+#if DEBUG
+static bool Matches(const PendingSplitBarrier& pending, const PendingSplitBarrier& barrier)
+{
+	return pending.Resource == barrier.Resource && pending.Access.Before == barrier.Access.Before &&
+		   pending.Access.After == barrier.Access.After && pending.Layout.Before == barrier.Layout.Before &&
+		   pending.Layout.After == barrier.Layout.After && pending.Subresources == barrier.Subresources;
+}
+
+void GraphicsContext::BeginSplitBarrier(const PendingSplitBarrier& barrier)
+{
+	for (usize i = 0; i < PendingSplitBarrierCount; ++i)
+	{
+		VERIFY(!Matches(PendingSplitBarriers[i], barrier), "A split barrier was begun again before it was ended!");
+	}
+	VERIFY(PendingSplitBarrierCount < MaxPendingSplitBarriers, "Too many split barriers are pending on this context!");
+	PendingSplitBarriers[PendingSplitBarrierCount++] = barrier;
+}
+
+void GraphicsContext::EndSplitBarrier(const PendingSplitBarrier& barrier)
+{
+	usize index = 0;
+	while (index < PendingSplitBarrierCount && !Matches(PendingSplitBarriers[index], barrier))
+	{
+		++index;
+	}
+	VERIFY(index < PendingSplitBarrierCount, "A split barrier was ended without a matching begin!");
+
+	PendingSplitBarriers[index] = PendingSplitBarriers[--PendingSplitBarrierCount];
+}
+#endif
+
 void GraphicsContext::BuildAccelerationStructure(const AccelerationStructureGeometry& geometry,
 												 const Resource* scratchResource,
 												 const Resource* resultResource) const
@@ -8,13 +8,26 @@
 namespace RHI::D3D12
 {
 
+#if DEBUG
+inline constexpr usize MaxPendingSplitBarriers = 64;
+
+// Buffers have no layout or subresources, so theirs are left zeroed.
+struct PendingSplitBarrier
+{
+	ID3D12Resource2* Resource;
+	BarrierPair<BarrierAccess> Access;
+	BarrierPair<BarrierLayout> Layout;
+	BarrierSubresourceRange Subresources;
+};
+#endif
+
 class GraphicsContext final : public GraphicsContextDescription, NoCopy
 {
 public:
 	GraphicsContext(const GraphicsContextDescription& description, Device* device);
 	~GraphicsContext();
 
-	void Begin() const;
+	void Begin();
 	void End();
 
 	void SetViewport(uint32 width, uint32 height) const;
@@ -27,28 +40,75 @@ public:
 	void ClearRenderTarget(const TextureView* renderTarget) const;
 	void ClearDepthStencil(const TextureView* depthStencil) const;
 
+	void ClearUnorderedAccess(const BufferView* buffer, uint32 value) const;
+	void ClearUnorderedAccess(const TextureView* texture, const Float4& value) const;
+	void ClearUnorderedAccess(const TextureView* texture, uint32 value) const;
+
 	void SetPipeline(GraphicsPipeline* pipeline);
 	void SetPipeline(ComputePipeline* pipeline);
 
 	void SetVertexBuffer(usize slot, const SubBuffer& vertexBuffer) const;
+	void SetVertexBuffers(usize startSlot, const ArrayView<const SubBuffer>& vertexBuffers) const;
 	void SetIndexBuffer(const SubBuffer& indexBuffer) const;
 
 	void SetConstantBuffer(StringView name, const Resource* buffer, usize offset = 0) const;
+	void SetShaderResource(StringView name, const Resource* buffer, usize offset = 0) const;
+	void SetUnorderedAccess(StringView name, const Resource* buffer, usize offset = 0) const;
 
 	void SetRootConstants(const void* data) const;
 
 	void Draw(usize vertexCount) const;
-	void DrawIndexed(usize indexCount) const;
+	void DrawIndexed(usize indexCount, usize firstIndex, int32 baseVertex) const;
 	void Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ) const;
 
 	void Copy(const Resource* destination, const Resource* source) const;
+	void CopyBufferRegion(const Resource* destination,
+						  usize destinationOffset,
+						  const Resource* source,
+						  usize sourceOffset,
+						  usize size) const;
+	void CopyTextureRegion(const Resource* destination,
+						   uint32 destinationMipLevel,
+						   uint32 destinationX,
+						   uint32 destinationY,
+						   const Resource* source,
+						   const TextureRegion& sourceRegion) const;
+
+	ReadbackTicket EnqueueReadback(ReadbackRing* readbackRing, const SubBuffer& source) const;
+	ReadbackTicket EnqueueReadback(ReadbackRing* readbackRing, const Resource* texture, uint32 mipLevel) const;
+
+	void BeginQuery(const QueryPool* queryPool, usize index) const;
+	void EndQuery(const QueryPool* queryPool, usize index) const;
+	void ResolveQueryData(const QueryPool* queryPool, usize firstIndex, usize count, const Resource* destination, usize offset) const;
+
+	void SetPredication(const Resource* buffer, usize offset, PredicationOperation operation) const;
+	void ClearPredication() const;
 
 	void GlobalBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access) const;
 	void BufferBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access, const Resource* buffer) const;
 	void TextureBarrier(BarrierPair<BarrierStage> stage,
 						BarrierPair<BarrierAccess> access,
 						BarrierPair<BarrierLayout> layout,
-						const Resource* texture) const;
+						const Resource* texture,
+						const BarrierSubresourceRange& subresources) const;
+
+	void BeginBufferBarrier(BarrierStage stageBefore, BarrierPair<BarrierAccess> access, const Resource* buffer);
+	void EndBufferBarrier(BarrierStage stageAfter, BarrierPair<BarrierAccess> access, const Resource* buffer);
+	void BeginTextureBarrier(BarrierStage stageBefore,
+							 BarrierPair<BarrierAccess> access,
+							 BarrierPair<BarrierLayout> layout,
+							 const Resource* texture,
+							 const BarrierSubresourceRange& subresources);
+	void EndTextureBarrier(BarrierStage stageAfter,
+						   BarrierPair<BarrierAccess> access,
+						   BarrierPair<BarrierLayout> layout,
+						   const Resource* texture,
+						   const BarrierSubresourceRange& subresources);
+
+#if DEBUG
+	void BeginSplitBarrier(const PendingSplitBarrier& barrier);
+	void EndSplitBarrier(const PendingSplitBarrier& barrier);
+#endif
 
 	void BuildAccelerationStructure(const AccelerationStructureGeometry& geometry,
 									const Resource* scratchResource,
@@ -59,15 +119,27 @@ public:
 
 	void Execute(ID3D12CommandQueue* queue) const;
 
-	ID3D12CommandAllocator* CommandAllocators[FramesInFlight];
+	ID3D12CommandAllocator* CommandAllocators[MaxFramesInFlight];
 	ID3D12GraphicsCommandList10* Native;
 
 	Pipeline* CurrentPipeline;
+
+	// Pipelines often share a root signature, so it is only set when it changes.
+	ID3D12RootSignature* CurrentGraphicsRootSignature;
+	ID3D12RootSignature* CurrentComputeRootSignature;
+	PrimitiveTopology CurrentPrimitiveTopology;
 	Device* Device;
 
+#if DEBUG
+	// Split barriers begun on this command list and not yet ended, which must be none by End.
+	PendingSplitBarrier PendingSplitBarriers[MaxPendingSplitBarriers];
+	usize PendingSplitBarrierCount;
+#endif
+
 #if !RELEASE
 	ID3D12QueryHeap* FrameTimeQueryHeap;
 	Resource* FrameTimeQueryResource;
+	usize FrameTimeResolveIndex;
 #endif
 
 	double MostRecentGpuTime;
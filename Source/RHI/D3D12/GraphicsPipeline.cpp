@@ -8,26 +8,124 @@ namespace RHI::D3D12
 {
 
 GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& description, D3D12::Device* device)
+	: GraphicsPipeline(description, device, PipelinePriority::Normal, nullptr)
+{
+	Build();
+}
+
+GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& description,
+								   D3D12::Device* device,
+								   PipelinePriority priority,
+								   GraphicsPipeline* fallback)
 	: Pipeline(device)
 	, GraphicsPipelineDescription(description)
+	, Priority(priority)
+	, Fallback(fallback)
+	, CompilePrevious(nullptr)
+	, CompileNext(nullptr)
+	, Queued(false)
+	, Built(0)
+	, VertexBytecode(nullptr)
+	, PixelBytecode(nullptr)
+	, VertexReflection()
+	, PixelReflection()
+	, OwnedVertexAttributes(description.VertexAttributes.GetLength(), Allocator)
+	, OwnedStrings(Allocator)
 {
+	CHECK(!Fallback || Fallback->IsReady());
 	CHECK(RenderTargetFormats.GetLength() <= MaxRenderTargetCount);
+	CHECK(RenderTargetBlends.GetLength() <= MaxRenderTargetCount);
+
+	for (usize i = 0; i < RenderTargetFormats.GetLength(); ++i)
+	{
+		OwnedRenderTargetFormats[i] = RenderTargetFormats[i];
+	}
+	RenderTargetFormats = ArrayView<const ResourceFormat>(OwnedRenderTargetFormats, RenderTargetFormats.GetLength());
+
+	for (usize i = 0; i < RenderTargetBlends.GetLength(); ++i)
+	{
+		OwnedRenderTargetBlends[i] = RenderTargetBlends[i];
+	}
+	RenderTargetBlends = ArrayView<const RenderTargetBlend>(OwnedRenderTargetBlends, RenderTargetBlends.GetLength());
+
+	// Sized up front so the views taken into it below are not moved by a later growth.
+	usize stringsLength = Name.GetLength();
+	for (const VertexAttribute& attribute : VertexAttributes)
+	{
+		stringsLength += attribute.Semantic.GetLength();
+	}
+	OwnedStrings.GrowToLengthUninitialized(stringsLength);
+
+	usize stringsOffset = 0;
+	const auto ownString = [&](StringView string) -> StringView
+	{
+		char* owned = OwnedStrings.GetData() + stringsOffset;
+		Platform::MemoryCopy(owned, string.GetData(), string.GetLength());
+		stringsOffset += string.GetLength();
+		return StringView(owned, string.GetLength());
+	};
 
+	for (const VertexAttribute& attribute : VertexAttributes)
+	{
+		VertexAttribute owned = attribute;
+		owned.Semantic = ownString(attribute.Semantic);
+		OwnedVertexAttributes.Add(owned);
+	}
+	VertexAttributes = ArrayView<const VertexAttribute>(OwnedVertexAttributes.GetData(), OwnedVertexAttributes.GetLength());
+
+	Name = ownString(Name);
+
+	CaptureShaders();
+}
+
+GraphicsPipeline::~GraphicsPipeline()
+{
+	SAFE_RELEASE(VertexBytecode);
+	SAFE_RELEASE(PixelBytecode);
+}
+
+void GraphicsPipeline::CaptureShaders()
+{
 	CHECK(Stages.Contains(ShaderStage::Vertex));
 	const bool usesPixelShader = Stages.Contains(ShaderStage::Pixel);
 	CHECK(usesPixelShader ? (Stages.GetCount() == 2) : (Stages.GetCount() == 1));
 
 	const Shader* backendVertexShader = Stages[ShaderStage::Vertex].Backend;
 	const Shader* backendPixelShader = usesPixelShader ? Stages[ShaderStage::Pixel].Backend : nullptr;
+	VERIFY(backendVertexShader->Blob && (!usesPixelShader || backendPixelShader->Blob),
+		   "Shader bytecode was released before the pipeline was created!");
+
+	SAFE_RELEASE(VertexBytecode);
+	SAFE_RELEASE(PixelBytecode);
+
+	VertexBytecode = backendVertexShader->Blob;
+	VertexBytecode->AddRef();
+	VertexReflection = backendVertexShader->Reflection;
+	if (usesPixelShader)
+	{
+		PixelBytecode = backendPixelShader->Blob;
+		PixelBytecode->AddRef();
+		PixelReflection = backendPixelShader->Reflection;
+	}
+}
+
+void GraphicsPipeline::Build()
+{
+	CHECK(RenderTargetFormats.GetLength() <= MaxRenderTargetCount);
+	CHECK(RenderTargetBlends.GetLength() == 0 || RenderTargetBlends.GetLength() == RenderTargetFormats.GetLength());
+
+	CHECK(VertexBytecode);
+	const bool usesPixelShader = PixelBytecode != nullptr;
 
 	Array<D3D12_INPUT_ELEMENT_DESC> inputElements(Allocator);
-	DXC::ReflectInputElements(backendVertexShader->Reflection, inputElements);
+	DXC::ReflectInputElements(VertexReflection, VertexAttributes, inputElements);
 
 	HashTable<String, D3D12_ROOT_PARAMETER1> apiRootParameters(BindingBucketCount, Allocator);
-	DXC::ReflectRootParameters(backendVertexShader->Reflection, &RootParameters, &apiRootParameters);
+	Array<D3D12_STATIC_SAMPLER_DESC> staticSamplers(Allocator);
+	DXC::ReflectRootParameters(VertexReflection, &RootParameters, &apiRootParameters, &staticSamplers);
 	if (usesPixelShader)
 	{
-		DXC::ReflectRootParameters(backendPixelShader->Reflection, &RootParameters, &apiRootParameters);
+		DXC::ReflectRootParameters(PixelReflection, &RootParameters, &apiRootParameters, &staticSamplers);
 	}
 
 	Array<D3D12_ROOT_PARAMETER1> rootParametersList(apiRootParameters.GetCount(), Allocator);
@@ -43,77 +141,51 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& descriptio
 		{
 			.NumParameters = static_cast<uint32>(rootParametersList.GetLength()),
 			.pParameters = rootParametersList.GetData(),
-			.NumStaticSamplers = 0,
-			.pStaticSamplers = nullptr,
+			.NumStaticSamplers = static_cast<uint32>(staticSamplers.GetLength()),
+			.pStaticSamplers = staticSamplers.GetData(),
 			.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
 					 D3D12_ROOT_SIGNATURE_FLAG_CBV_SRV_UAV_HEAP_DIRECTLY_INDEXED |
 					 D3D12_ROOT_SIGNATURE_FLAG_SAMPLER_HEAP_DIRECTLY_INDEXED,
 		},
 	};
-	ID3DBlob* serializedRootSignature = nullptr;
-	ID3DBlob* errorBlob = nullptr;
-	const HRESULT rootSignatureResult = D3D12SerializeVersionedRootSignature(&rootSignatureDescription, &serializedRootSignature, &errorBlob);
-#if DEBUG
-	if (FAILED(rootSignatureResult) && errorBlob)
+	Device->CreateRootSignature(rootSignatureDescription, &RootSignature);
+
+	D3D12_BLEND_DESC blendDescription =
+	{
+		.AlphaToCoverageEnable = false,
+		.IndependentBlendEnable = RenderTargetBlends.GetLength() > 1,
+		.RenderTarget = {},
+	};
+	for (usize i = 0; i < MaxRenderTargetCount; ++i)
 	{
-		char errorMessage[512] = {};
-		Platform::StringPrint("Root Signature Error: %s\n", errorMessage, sizeof(errorMessage), errorBlob->GetBufferPointer());
-		Platform::FatalError(errorMessage);
+		const RenderTargetBlend blend = i < RenderTargetBlends.GetLength() ? RenderTargetBlends[i] : RenderTargetBlend {};
+		blendDescription.RenderTarget[i] = To(blend, AlphaBlend);
 	}
-#else
-	(void)rootSignatureResult;
-#endif
-	CHECK(serializedRootSignature);
-	CHECK_RESULT(device->Native->CreateRootSignature(0,
-													 serializedRootSignature->GetBufferPointer(),
-													 serializedRootSignature->GetBufferSize(),
-													 IID_PPV_ARGS(&RootSignature)));
-	SET_D3D_NAME(RootSignature, Name);
 
 	const D3D12_GRAPHICS_PIPELINE_STATE_DESC graphicsPipelineStateDescription =
 	{
 		.pRootSignature = RootSignature,
 		.VS = D3D12_SHADER_BYTECODE
 		{
-			.pShaderBytecode = backendVertexShader->Blob->GetBufferPointer(),
-			.BytecodeLength = backendVertexShader->Blob->GetBufferSize(),
+			.pShaderBytecode = VertexBytecode->GetBufferPointer(),
+			.BytecodeLength = VertexBytecode->GetBufferSize(),
 		},
 		.PS = D3D12_SHADER_BYTECODE
 		{
-			.pShaderBytecode = usesPixelShader ? backendPixelShader->Blob->GetBufferPointer() : nullptr,
-			.BytecodeLength = usesPixelShader ? backendPixelShader->Blob->GetBufferSize() : 0,
+			.pShaderBytecode = usesPixelShader ? PixelBytecode->GetBufferPointer() : nullptr,
+			.BytecodeLength = usesPixelShader ? PixelBytecode->GetBufferSize() : 0,
 		},
 		.StreamOutput = {},
-		.BlendState = D3D12_BLEND_DESC
-		{
-			.AlphaToCoverageEnable = false,
-			.IndependentBlendEnable = false,
-			.RenderTarget =
-			{
-				D3D12_RENDER_TARGET_BLEND_DESC
-				{
-					.BlendEnable = AlphaBlend,
-					.LogicOpEnable = false,
-					.SrcBlend = AlphaBlend ? D3D12_BLEND_SRC_ALPHA : D3D12_BLEND_ONE,
-					.DestBlend = AlphaBlend ? D3D12_BLEND_INV_SRC_ALPHA : D3D12_BLEND_ZERO,
-					.BlendOp = D3D12_BLEND_OP_ADD,
-					.SrcBlendAlpha = D3D12_BLEND_ONE,
-					.DestBlendAlpha = D3D12_BLEND_ZERO,
-					.BlendOpAlpha = D3D12_BLEND_OP_ADD,
-					.LogicOp = D3D12_LOGIC_OP_NOOP,
-					.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL,
-				},
-			},
-		},
+		.BlendState = blendDescription,
 		.SampleMask = D3D12_DEFAULT_SAMPLE_MASK,
 		.RasterizerState = D3D12_RASTERIZER_DESC
 		{
 			.FillMode = D3D12_FILL_MODE_SOLID,
-			.CullMode = D3D12_CULL_MODE_BACK,
+			.CullMode = To(CullMode),
 			.FrontCounterClockwise = true,
-			.DepthBias = D3D12_DEFAULT_DEPTH_BIAS,
-			.DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP,
-			.SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS,
+			.DepthBias = DepthBias.Constant,
+			.DepthBiasClamp = DepthBias.Clamp,
+			.SlopeScaledDepthBias = DepthBias.SlopeScaled,
 			.DepthClipEnable = true,
 			.MultisampleEnable = false,
 			.AntialiasedLineEnable = false,
@@ -123,8 +195,8 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& descriptio
 		.DepthStencilState = D3D12_DEPTH_STENCIL_DESC
 		{
 			.DepthEnable = IsDepthFormat(DepthStencilFormat),
-			.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL,
-			.DepthFunc = description.ReverseDepth ? D3D12_COMPARISON_FUNC_GREATER_EQUAL : D3D12_COMPARISON_FUNC_LESS_EQUAL,
+			.DepthWriteMask = DisableDepthWrite ? D3D12_DEPTH_WRITE_MASK_ZERO : D3D12_DEPTH_WRITE_MASK_ALL,
+			.DepthFunc = To(DepthFunction, ReverseDepth),
 			.StencilEnable = IsStencilFormat(DepthStencilFormat),
 			.StencilReadMask = D3D12_DEFAULT_STENCIL_READ_MASK,
 			.StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK,
@@ -149,7 +221,7 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& descriptio
 			.NumElements = static_cast<uint32>(inputElements.GetLength()),
 		},
 		.IBStripCutValue = D3D12_INDEX_BUFFER_STRIP_CUT_VALUE_DISABLED,
-		.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+		.PrimitiveTopologyType = ToType(PrimitiveTopology),
 		.NumRenderTargets = usesPixelShader ? static_cast<uint32>(RenderTargetFormats.GetLength()) : 0,
 		.RTVFormats =
 		{
@@ -168,9 +240,46 @@ GraphicsPipeline::GraphicsPipeline(const GraphicsPipelineDescription& descriptio
 		.CachedPSO = {},
 		.Flags = D3D12_PIPELINE_STATE_FLAG_NONE,
 	};
-	CHECK_RESULT(device->Native->CreateGraphicsPipelineState(&graphicsPipelineStateDescription, IID_PPV_ARGS(&PipelineState)));
+	Device->CreatePipelineState(graphicsPipelineStateDescription, &PipelineState);
 	SET_D3D_NAME(PipelineState, Name);
+
+	SAFE_RELEASE(VertexBytecode);
+	SAFE_RELEASE(PixelBytecode);
+
+	InterlockedExchange(&Built, 1);
+	WakeByAddressAll(const_cast<LONG*>(&Built));
+}
+
+#if !RELEASE
+bool GraphicsPipeline::UsesReloadedShader() const
+{
+	for (const auto& [_, shader] : Stages)
+	{
+		if (shader.Backend->Reloaded)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void GraphicsPipeline::Rebuild(RetiredPipeline* retired)
+{
+	// A pipeline still waiting to be built only takes the reloaded shaders for when it is. Compiler threads build while
+	// holding the hot reload lock, which Apply holds exclusively around this.
+	if (!IsReady())
+	{
+		retired->RootSignature = nullptr;
+		retired->PipelineState = nullptr;
+		CaptureShaders();
+		return;
+	}
+
+	GraphicsPipeline* replacement = Allocator->Create<GraphicsPipeline>(static_cast<const GraphicsPipelineDescription&>(*this), Device);
+	Replace(replacement, retired);
+	Allocator->Destroy(replacement);
 }
+#endif
 
 void GraphicsPipeline::SetConstantBuffer(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
 {
@@ -184,6 +293,32 @@ void GraphicsPipeline::SetConstantBuffer(ID3D12GraphicsCommandList10* commandLis
 	);
 }
 
+void GraphicsPipeline::SetShaderResource(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
+{
+	CHECK(RootParameters.Contains(name));
+	const DXC::RootParameter& rootParameter = RootParameters[name];
+	CHECK(rootParameter.Type == ReflectedBindingType::ShaderResource);
+
+	commandList->SetGraphicsRootShaderResourceView
+	(
+		static_cast<uint32>(rootParameter.Index),
+		D3D12_GPU_VIRTUAL_ADDRESS { buffer->Native->GetGPUVirtualAddress() + offset }
+	);
+}
+
+void GraphicsPipeline::SetUnorderedAccess(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset)
+{
+	CHECK(RootParameters.Contains(name));
+	const DXC::RootParameter& rootParameter = RootParameters[name];
+	CHECK(rootParameter.Type == ReflectedBindingType::UnorderedAccess);
+
+	commandList->SetGraphicsRootUnorderedAccessView
+	(
+		static_cast<uint32>(rootParameter.Index),
+		D3D12_GPU_VIRTUAL_ADDRESS { buffer->Native->GetGPUVirtualAddress() + offset }
+	);
+}
+
 void GraphicsPipeline::SetConstants(ID3D12GraphicsCommandList10* commandList, const void* data)
 {
 	static const StringView name = "RootConstants"_view;
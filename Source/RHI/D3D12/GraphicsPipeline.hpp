@@ -8,13 +8,57 @@
 namespace RHI::D3D12
 {
 
-class GraphicsPipeline final : public Pipeline, GraphicsPipelineDescription
+class GraphicsPipeline final : public Pipeline, public GraphicsPipelineDescription
 {
 public:
 	GraphicsPipeline(const GraphicsPipelineDescription& description, D3D12::Device* device);
 
+	// Leaves building to the PipelineCompiler.
+	GraphicsPipeline(const GraphicsPipelineDescription& description,
+					 D3D12::Device* device,
+					 PipelinePriority priority,
+					 GraphicsPipeline* fallback);
+	~GraphicsPipeline();
+
+	void Build();
+	bool IsReady() const { return Built != 0; }
+
 	virtual void SetConstantBuffer(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
+	virtual void SetShaderResource(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
+	virtual void SetUnorderedAccess(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) override;
 	virtual void SetConstants(ID3D12GraphicsCommandList10* commandList, const void* data) override;
+
+#if !RELEASE
+	virtual bool UsesReloadedShader() const override;
+	virtual void Rebuild(RetiredPipeline* retired) override;
+#endif
+
+	PipelinePriority Priority;
+	GraphicsPipeline* Fallback;
+
+	// Owned by the PipelineCompiler's lock.
+	GraphicsPipeline* CompilePrevious;
+	GraphicsPipeline* CompileNext;
+	bool Queued;
+
+	volatile LONG Built;
+
+private:
+	void CaptureShaders();
+
+	// The stage shaders' bytecode and reflection as they were at creation, so a build on a compiler thread does not
+	// depend on the shaders still being alive or holding their bytecode. The bytecode is released once built.
+	IDxcBlob* VertexBytecode;
+	IDxcBlob* PixelBytecode;
+	RHI::ShaderReflection VertexReflection;
+	RHI::ShaderReflection PixelReflection;
+
+	// Building may run on a compiler thread after the caller's description is gone, so the arrays and strings it
+	// points at are copied here and the description's views point into these instead.
+	ResourceFormat OwnedRenderTargetFormats[MaxRenderTargetCount];
+	RenderTargetBlend OwnedRenderTargetBlends[MaxRenderTargetCount];
+	Array<VertexAttribute> OwnedVertexAttributes;
+	Array<char> OwnedStrings;
 };
 
 }
@@ -0,0 +1,413 @@
+#include "HotReload.hpp"
+#include "Device.hpp"
+#include "Pipeline.hpp"
+#include "Shader.hpp"
+
+#include "dxc/dxcapi.h"
+
+#include <cwchar>
+
+#if !RELEASE
+
+namespace RHI::D3D12
+{
+
+static constexpr usize MaxChangedFiles = 64;
+static constexpr uint32 SettleMilliseconds = 50;
+
+struct ChangedFile
+{
+	wchar_t Path[MAX_PATH];
+};
+
+template<typename T>
+static void LinkFront(T** head, T* node)
+{
+	node->HotReloadPrevious = nullptr;
+	node->HotReloadNext = *head;
+	if (*head)
+	{
+		(*head)->HotReloadPrevious = node;
+	}
+	*head = node;
+}
+
+template<typename T>
+static void Unlink(T** head, T* node)
+{
+	if (node->HotReloadPrevious)
+	{
+		node->HotReloadPrevious->HotReloadNext = node->HotReloadNext;
+	}
+	else
+	{
+		*head = node->HotReloadNext;
+	}
+	if (node->HotReloadNext)
+	{
+		node->HotReloadNext->HotReloadPrevious = node->HotReloadPrevious;
+	}
+	node->HotReloadPrevious = nullptr;
+	node->HotReloadNext = nullptr;
+}
+
+static void GetFullPath(const wchar_t* path, wchar_t* fullPath)
+{
+	if (GetFullPathNameW(path, MAX_PATH, fullPath, nullptr) == 0)
+	{
+		wcsncpy_s(fullPath, MAX_PATH, path, _TRUNCATE);
+	}
+}
+
+static bool IsChanged(const wchar_t* path, const ChangedFile* changedFiles, usize changedFileCount)
+{
+	wchar_t fullPath[MAX_PATH] = {};
+	GetFullPath(path, fullPath);
+
+	for (usize i = 0; i < changedFileCount; ++i)
+	{
+		if (_wcsicmp(fullPath, changedFiles[i].Path) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool DependsOn(const Shader* shader, const ChangedFile* changedFiles, usize changedFileCount)
+{
+	wchar_t sourcePath[MAX_PATH] = {};
+	MultiByteToWideChar(CP_UTF8,
+						0,
+						shader->FilePath.GetData(),
+						static_cast<int32>(shader->FilePath.GetLength()),
+						sourcePath,
+						MAX_PATH - 1);
+	if (IsChanged(sourcePath, changedFiles, changedFileCount))
+	{
+		return true;
+	}
+
+	for (const DXC::CacheDependency& dependency : shader->Dependencies)
+	{
+		if (IsChanged(dependency.Path, changedFiles, changedFileCount))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static void ReleaseOutput(DXC::CompileOutput* output)
+{
+	SAFE_RELEASE(output->Blob);
+	Allocator->Destroy(output);
+}
+
+static DWORD WINAPI HotReloadThread(void* parameter)
+{
+	static_cast<HotReload*>(parameter)->Watch();
+	return 0;
+}
+
+HotReload::HotReload(StringView watchPath, D3D12::Device* device)
+	: WatchDirectory()
+	, Directory(INVALID_HANDLE_VALUE)
+	, ChangeEvent(nullptr)
+	, ExitEvent(nullptr)
+	, Thread(nullptr)
+	, Lock(SRWLOCK_INIT)
+	, CompileLock(SRWLOCK_INIT)
+	, Shaders(nullptr)
+	, Pipelines(nullptr)
+	, Retired()
+	, RetiredStart(0)
+	, RetiredCount(0)
+	, Device(device)
+{
+	wchar_t watchPathBuffer[MAX_PATH] = {};
+	MultiByteToWideChar(CP_UTF8, 0, watchPath.GetData(), static_cast<int32>(watchPath.GetLength()), watchPathBuffer, MAX_PATH - 1);
+	GetFullPath(watchPathBuffer, WatchDirectory);
+
+	Directory = CreateFileW(WatchDirectory,
+							FILE_LIST_DIRECTORY,
+							FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+							nullptr,
+							OPEN_EXISTING,
+							FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+							nullptr);
+	VERIFY(Directory != INVALID_HANDLE_VALUE, "Failed to open the shader hot reload directory!");
+
+	ChangeEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+	ExitEvent = CreateEventEx(nullptr, nullptr, CREATE_EVENT_MANUAL_RESET, EVENT_ALL_ACCESS);
+	CHECK(ChangeEvent && ExitEvent);
+
+	Thread = CreateThread(nullptr, 0, HotReloadThread, this, 0, nullptr);
+	CHECK(Thread);
+}
+
+HotReload::~HotReload()
+{
+	SetEvent(ExitEvent);
+	WaitForSingleObject(Thread, INFINITE);
+	CloseHandle(Thread);
+	CloseHandle(ExitEvent);
+	CloseHandle(ChangeEvent);
+	CloseHandle(Directory);
+
+	for (Shader* shader = Shaders; shader; shader = shader->HotReloadNext)
+	{
+		if (shader->PendingReload)
+		{
+			ReleaseOutput(shader->PendingReload);
+			shader->PendingReload = nullptr;
+		}
+	}
+
+	for (; RetiredCount > 0; --RetiredCount)
+	{
+		RetiredPipeline& retired = Retired[RetiredStart];
+		SAFE_RELEASE(retired.RootSignature);
+		SAFE_RELEASE(retired.PipelineState);
+		RetiredStart = (RetiredStart + 1) % MaxRetiredPipelines;
+	}
+}
+
+void HotReload::Add(Shader* shader)
+{
+	AcquireSRWLockExclusive(&Lock);
+	LinkFront(&Shaders, shader);
+	ReleaseSRWLockExclusive(&Lock);
+}
+
+void HotReload::Remove(Shader* shader)
+{
+	// Waits out a compile that may be reading the shader.
+	AcquireSRWLockShared(&CompileLock);
+	AcquireSRWLockExclusive(&Lock);
+	Unlink(&Shaders, shader);
+	if (shader->PendingReload)
+	{
+		ReleaseOutput(shader->PendingReload);
+		shader->PendingReload = nullptr;
+	}
+	ReleaseSRWLockExclusive(&Lock);
+	ReleaseSRWLockShared(&CompileLock);
+}
+
+void HotReload::Add(Pipeline* pipeline)
+{
+	AcquireSRWLockExclusive(&Lock);
+	LinkFront(&Pipelines, pipeline);
+	ReleaseSRWLockExclusive(&Lock);
+}
+
+void HotReload::Remove(Pipeline* pipeline)
+{
+	AcquireSRWLockExclusive(&Lock);
+	Unlink(&Pipelines, pipeline);
+	ReleaseSRWLockExclusive(&Lock);
+}
+
+void HotReload::Apply(uint64 frameFenceValue, uint64 completedFenceValue)
+{
+	while (RetiredCount > 0 && Retired[RetiredStart].FenceValue <= completedFenceValue)
+	{
+		RetiredPipeline& retired = Retired[RetiredStart];
+		SAFE_RELEASE(retired.RootSignature);
+		SAFE_RELEASE(retired.PipelineState);
+		RetiredStart = (RetiredStart + 1) % MaxRetiredPipelines;
+		--RetiredCount;
+	}
+
+	// The watcher only holds the lock briefly to publish. Rather than stall the frame, pick the results up at a later one.
+	if (!TryAcquireSRWLockExclusive(&Lock))
+	{
+		return;
+	}
+
+	usize pipelineCount = 0;
+	for (const Pipeline* pipeline = Pipelines; pipeline; pipeline = pipeline->HotReloadNext)
+	{
+		++pipelineCount;
+	}
+
+	bool reloaded = false;
+	if (RetiredCount + pipelineCount <= MaxRetiredPipelines)
+	{
+		for (Shader* shader = Shaders; shader; shader = shader->HotReloadNext)
+		{
+			if (!shader->PendingReload)
+			{
+				continue;
+			}
+
+			SAFE_RELEASE(shader->Blob);
+			shader->Blob = shader->PendingReload->Blob;
+			shader->Reflection = shader->PendingReload->Reflection;
+			shader->Dependencies = Move(shader->PendingReload->Dependencies);
+
+			shader->PendingReload->Blob = nullptr;
+			ReleaseOutput(shader->PendingReload);
+			shader->PendingReload = nullptr;
+
+			shader->Reloaded = true;
+			reloaded = true;
+		}
+	}
+
+	if (reloaded)
+	{
+		for (Pipeline* pipeline = Pipelines; pipeline; pipeline = pipeline->HotReloadNext)
+		{
+			if (!pipeline->UsesReloadedShader())
+			{
+				continue;
+			}
+
+			RetiredPipeline& retired = Retired[(RetiredStart + RetiredCount) % MaxRetiredPipelines];
+			pipeline->Rebuild(&retired);
+			retired.FenceValue = frameFenceValue;
+			++RetiredCount;
+		}
+
+		for (Shader* shader = Shaders; shader; shader = shader->HotReloadNext)
+		{
+			shader->Reloaded = false;
+		}
+	}
+
+	ReleaseSRWLockExclusive(&Lock);
+}
+
+void HotReload::Watch()
+{
+	IDxcCompiler3* compiler = nullptr;
+	IDxcUtils* utils = nullptr;
+	DXC::CreateCompiler(&compiler, &utils);
+
+	alignas(DWORD) uint8 notifications[16 * 1024];
+	ChangedFile changedFiles[MaxChangedFiles];
+
+	while (true)
+	{
+		OVERLAPPED overlapped = {};
+		overlapped.hEvent = ChangeEvent;
+		const bool reading = ReadDirectoryChangesW(Directory,
+												   notifications,
+												   sizeof(notifications),
+												   true,
+												   FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME,
+												   nullptr,
+												   &overlapped,
+												   nullptr);
+		CHECK(reading);
+
+		const HANDLE events[] = { ExitEvent, ChangeEvent };
+		if (WaitForMultipleObjects(ARRAY_COUNT(events), events, false, INFINITE) == WAIT_OBJECT_0)
+		{
+			DWORD unused = 0;
+			CancelIoEx(Directory, &overlapped);
+			GetOverlappedResult(Directory, &overlapped, &unused, true);
+			break;
+		}
+
+		DWORD notificationsSize = 0;
+		if (!GetOverlappedResult(Directory, &overlapped, &notificationsSize, false) || notificationsSize == 0)
+		{
+			continue;
+		}
+
+		usize changedFileCount = 0;
+		for (usize offset = 0; changedFileCount < MaxChangedFiles;)
+		{
+			const FILE_NOTIFY_INFORMATION* notification = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(notifications + offset);
+
+			wchar_t path[MAX_PATH] = {};
+			swprintf_s(path,
+					   ARRAY_COUNT(path),
+					   L"%s\\%.*s",
+					   WatchDirectory,
+					   static_cast<int32>(notification->FileNameLength / sizeof(wchar_t)),
+					   notification->FileName);
+			GetFullPath(path, changedFiles[changedFileCount++].Path);
+
+			if (notification->NextEntryOffset == 0)
+			{
+				break;
+			}
+			offset += notification->NextEntryOffset;
+		}
+
+		// Editors tend to save in several writes. Let them finish before reading the files back.
+		Sleep(SettleMilliseconds);
+
+		// Compiling can take seconds, so it runs without the lock that Add and Apply take. Holding CompileLock instead
+		// keeps the changed shaders alive until their outputs are published.
+		AcquireSRWLockExclusive(&CompileLock);
+
+		Array<Shader*> changedShaders(Allocator);
+		AcquireSRWLockShared(&Lock);
+		for (Shader* shader = Shaders; shader; shader = shader->HotReloadNext)
+		{
+			if (DependsOn(shader, changedFiles, changedFileCount))
+			{
+				changedShaders.Add(shader);
+			}
+		}
+		ReleaseSRWLockShared(&Lock);
+
+		Array<DXC::CompileOutput*> outputs(changedShaders.GetLength(), Allocator);
+		for (const Shader* shader : changedShaders)
+		{
+			DXC::CompileOutput* output = Allocator->Create<DXC::CompileOutput>(DXC::CompileOutput
+			{
+				.Blob = nullptr,
+				.Reflection = {},
+				.Dependencies = Array<DXC::CacheDependency>(Allocator),
+			});
+
+			String error(0, Allocator);
+			if (!DXC::CompileShader(compiler, utils, *shader, output, &error))
+			{
+				char errorMessage[2048];
+				Platform::StringPrint("Shader Hot Reload: %.*s\n",
+									  errorMessage,
+									  sizeof(errorMessage),
+									  static_cast<int32>(error.GetLength()),
+									  error.GetData());
+				OutputDebugStringA(errorMessage);
+
+				ReleaseOutput(output);
+				output = nullptr;
+			}
+			outputs.Add(output);
+		}
+
+		AcquireSRWLockExclusive(&Lock);
+		for (usize i = 0; i < changedShaders.GetLength(); ++i)
+		{
+			Shader* shader = changedShaders[i];
+			if (!outputs[i])
+			{
+				continue;
+			}
+
+			if (shader->PendingReload)
+			{
+				ReleaseOutput(shader->PendingReload);
+			}
+			shader->PendingReload = outputs[i];
+		}
+		ReleaseSRWLockExclusive(&Lock);
+
+		ReleaseSRWLockExclusive(&CompileLock);
+	}
+
+	SAFE_RELEASE(utils);
+	SAFE_RELEASE(compiler);
+}
+
+}
+
+#endif
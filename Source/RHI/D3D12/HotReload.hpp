@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Forward.hpp"
+
+#include "Luft/NoCopy.hpp"
+#include "Luft/String.hpp"
+
+#if !RELEASE
+
+namespace RHI::D3D12
+{
+
+inline constexpr usize MaxRetiredPipelines = 1024;
+
+struct RetiredPipeline
+{
+	ID3D12RootSignature* RootSignature;
+	ID3D12PipelineState* PipelineState;
+	uint64 FenceValue;
+};
+
+class HotReload final : public NoCopy
+{
+public:
+	HotReload(StringView watchPath, Device* device);
+	~HotReload();
+
+	void Add(Shader* shader);
+	void Remove(Shader* shader);
+	void Add(Pipeline* pipeline);
+	void Remove(Pipeline* pipeline);
+
+	void Apply(uint64 frameFenceValue, uint64 completedFenceValue);
+
+	void Watch();
+
+	wchar_t WatchDirectory[MAX_PATH];
+	HANDLE Directory;
+	HANDLE ChangeEvent;
+	HANDLE ExitEvent;
+	HANDLE Thread;
+
+	SRWLOCK Lock;
+	// Held by the watcher while it compiles outside Lock. Always taken before Lock.
+	SRWLOCK CompileLock;
+	Shader* Shaders;
+	Pipeline* Pipelines;
+
+	RetiredPipeline Retired[MaxRetiredPipelines];
+	usize RetiredStart;
+	usize RetiredCount;
+
+	Device* Device;
+};
+
+}
+
+#endif
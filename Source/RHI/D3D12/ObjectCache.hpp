@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Allocator.hpp"
+#include "RHI/Device.hpp"
+
+#include "Luft/HashTable.hpp"
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+inline constexpr usize ObjectCacheBucketCount = 64;
+
+template<typename T>
+struct CachedObject
+{
+	T* Object;
+	usize References;
+};
+
+// Hands the same backend object to every Create with an equal description, so duplicates share one native object and
+// one descriptor. Entries are keyed by the description's hash and checked against the live object's own description,
+// which every cached type keeps a copy of, so an entry outlives its object only as an empty slot. Release finds the
+// entry through the hash recorded when the object was added rather than hashing the object again. Like the rest of
+// object creation, it is not thread-safe.
+template<typename T, typename Description>
+class ObjectCache final : public NoCopy
+{
+public:
+	ObjectCache()
+		: Entries(ObjectCacheBucketCount, Allocator)
+		, ObjectHashes(ObjectCacheBucketCount, Allocator)
+		, Hits(0)
+		, Misses(0)
+		, Live(0)
+		, Duplicates(0)
+	{
+	}
+
+	T* Acquire(const Description& description)
+	{
+		const uint64 hash = Hash<Description>()(description);
+		if (Entries.Contains(hash))
+		{
+			CachedObject<T>& entry = Entries[hash];
+			if (entry.Object && static_cast<const Description&>(*entry.Object) == description)
+			{
+				++entry.References;
+				++Hits;
+				++Duplicates;
+				return entry.Object;
+			}
+		}
+		++Misses;
+		return nullptr;
+	}
+
+	void Add(const Description& description, T* object)
+	{
+		const uint64 hash = Hash<Description>()(description);
+		if (!Entries.Contains(hash))
+		{
+			Entries.Add(hash, CachedObject<T> { nullptr, 0 });
+		}
+
+		// A hash collision with a live object leaves the new one uncached.
+		CachedObject<T>& entry = Entries[hash];
+		if (!entry.Object)
+		{
+			entry = CachedObject<T> { object, 1 };
+			++Live;
+
+			const uint64 address = reinterpret_cast<uint64>(object);
+			if (ObjectHashes.Contains(address))
+			{
+				ObjectHashes[address] = hash;
+			}
+			else
+			{
+				ObjectHashes.Add(address, hash);
+			}
+		}
+	}
+
+	// Returns whether the object should be destroyed, which is once its last reference is gone.
+	bool Release(T* object)
+	{
+		const uint64 address = reinterpret_cast<uint64>(object);
+		if (!ObjectHashes.Contains(address))
+		{
+			return true;
+		}
+
+		// The address may belong to an earlier object, in which case its entry holds another object or none.
+		CachedObject<T>& entry = Entries[ObjectHashes[address]];
+		if (entry.Object != object)
+		{
+			return true;
+		}
+
+		if (--entry.References > 0)
+		{
+			--Duplicates;
+			return false;
+		}
+		entry.Object = nullptr;
+		--Live;
+		return true;
+	}
+
+	ObjectCacheCounters GetCounters(usize descriptorSize) const
+	{
+		return ObjectCacheCounters
+		{
+			.Hits = Hits,
+			.Misses = Misses,
+			.Live = Live,
+			.BytesSaved = Duplicates * (sizeof(T) + descriptorSize),
+		};
+	}
+
+	HashTable<uint64, CachedObject<T>> Entries;
+
+	// The hash each cached object was added under, keyed by its address. Stale addresses stay until they are reused.
+	HashTable<uint64, uint64> ObjectHashes;
+
+	usize Hits;
+	usize Misses;
+	usize Live;
+
+	// References beyond the first across every live object, each one an object and descriptor not created.
+	usize Duplicates;
+};
+
+}
@@ -10,4 +10,19 @@ Pipeline::~Pipeline()
 	SAFE_RELEASE(PipelineState);
 }
 
+#if !RELEASE
+void Pipeline::Replace(Pipeline* replacement, RetiredPipeline* retired)
+{
+	retired->RootSignature = RootSignature;
+	retired->PipelineState = PipelineState;
+
+	RootSignature = replacement->RootSignature;
+	PipelineState = replacement->PipelineState;
+	RootParameters = Move(replacement->RootParameters);
+
+	replacement->RootSignature = nullptr;
+	replacement->PipelineState = nullptr;
+}
+#endif
+
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "HotReload.hpp"
 #include "Shader.hpp"
 
 #include "RHI/Allocator.hpp"
@@ -19,17 +20,35 @@ public:
 		, RootSignature(nullptr)
 		, PipelineState(nullptr)
 		, Device(device)
+#if !RELEASE
+		, HotReloadPrevious(nullptr)
+		, HotReloadNext(nullptr)
+#endif
 	{
 	}
 	virtual ~Pipeline();
 
 	virtual void SetConstantBuffer(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) = 0;
+	virtual void SetShaderResource(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) = 0;
+	virtual void SetUnorderedAccess(ID3D12GraphicsCommandList10* commandList, StringView name, const Resource* buffer, usize offset) = 0;
 	virtual void SetConstants(ID3D12GraphicsCommandList10* commandList, const void* data) = 0;
 
+#if !RELEASE
+	virtual bool UsesReloadedShader() const = 0;
+	virtual void Rebuild(RetiredPipeline* retired) = 0;
+
+	void Replace(Pipeline* replacement, RetiredPipeline* retired);
+#endif
+
 	HashTable<String, DXC::RootParameter> RootParameters;
 	ID3D12RootSignature* RootSignature;
 	ID3D12PipelineState* PipelineState;
 	Device* Device;
+
+#if !RELEASE
+	Pipeline* HotReloadPrevious;
+	Pipeline* HotReloadNext;
+#endif
 };
 
 }
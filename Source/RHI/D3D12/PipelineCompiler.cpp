@@ -0,0 +1,199 @@
+#include "PipelineCompiler.hpp"
+#include "Device.hpp"
+#include "GraphicsPipeline.hpp"
+#include "HotReload.hpp"
+
+#pragma comment(lib, "Synchronization")
+
+namespace RHI::D3D12
+{
+
+static DWORD WINAPI PipelineCompileThread(void* parameter)
+{
+	static_cast<PipelineCompiler*>(parameter)->Run();
+	return 0;
+}
+
+static void Unlink(GraphicsPipeline* pipeline, GraphicsPipeline** heads, GraphicsPipeline** tails)
+{
+	const usize priority = static_cast<usize>(pipeline->Priority);
+	if (pipeline->CompilePrevious)
+	{
+		pipeline->CompilePrevious->CompileNext = pipeline->CompileNext;
+	}
+	else
+	{
+		heads[priority] = pipeline->CompileNext;
+	}
+	if (pipeline->CompileNext)
+	{
+		pipeline->CompileNext->CompilePrevious = pipeline->CompilePrevious;
+	}
+	else
+	{
+		tails[priority] = pipeline->CompilePrevious;
+	}
+
+	pipeline->CompilePrevious = nullptr;
+	pipeline->CompileNext = nullptr;
+	pipeline->Queued = false;
+}
+
+static void Build(GraphicsPipeline* pipeline)
+{
+#if !RELEASE
+	// Hot reload swaps shader bytecode while holding its lock exclusively.
+	HotReload* hotReload = pipeline->Device->ShaderHotReload;
+	if (hotReload)
+	{
+		AcquireSRWLockShared(&hotReload->Lock);
+	}
+#endif
+
+	pipeline->Build();
+
+#if !RELEASE
+	if (hotReload)
+	{
+		ReleaseSRWLockShared(&hotReload->Lock);
+	}
+#endif
+}
+
+static void WaitUntilBuilt(GraphicsPipeline* pipeline)
+{
+	LONG notBuilt = 0;
+	while (!pipeline->IsReady())
+	{
+		WaitOnAddress(&pipeline->Built, &notBuilt, sizeof(notBuilt), INFINITE);
+	}
+}
+
+PipelineCompiler::PipelineCompiler(D3D12::Device* device)
+	: Lock(SRWLOCK_INIT)
+	, Available(CONDITION_VARIABLE_INIT)
+	, Exiting(false)
+	, Heads()
+	, Tails()
+	, Threads()
+	, ThreadCount(0)
+	, Device(device)
+{
+	// Leave one core to the thread that records and submits frames.
+	const usize processorCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+	ThreadCount = processorCount > 1 ? processorCount - 1 : 1;
+	ThreadCount = ThreadCount < MaxPipelineCompileThreads ? ThreadCount : MaxPipelineCompileThreads;
+
+	for (usize i = 0; i < ThreadCount; ++i)
+	{
+		Threads[i] = CreateThread(nullptr, 0, PipelineCompileThread, this, 0, nullptr);
+		CHECK(Threads[i]);
+		SetThreadPriority(Threads[i], THREAD_PRIORITY_BELOW_NORMAL);
+	}
+}
+
+PipelineCompiler::~PipelineCompiler()
+{
+	AcquireSRWLockExclusive(&Lock);
+	Exiting = true;
+	ReleaseSRWLockExclusive(&Lock);
+	WakeAllConditionVariable(&Available);
+
+	WaitForMultipleObjects(static_cast<DWORD>(ThreadCount), Threads, TRUE, INFINITE);
+	for (usize i = 0; i < ThreadCount; ++i)
+	{
+		CloseHandle(Threads[i]);
+	}
+}
+
+void PipelineCompiler::Add(GraphicsPipeline* pipeline)
+{
+	const usize priority = static_cast<usize>(pipeline->Priority);
+	CHECK(priority < PipelinePriorityCount);
+
+	AcquireSRWLockExclusive(&Lock);
+	pipeline->CompilePrevious = Tails[priority];
+	pipeline->CompileNext = nullptr;
+	if (Tails[priority])
+	{
+		Tails[priority]->CompileNext = pipeline;
+	}
+	else
+	{
+		Heads[priority] = pipeline;
+	}
+	Tails[priority] = pipeline;
+	pipeline->Queued = true;
+	ReleaseSRWLockExclusive(&Lock);
+
+	WakeConditionVariable(&Available);
+}
+
+void PipelineCompiler::Remove(GraphicsPipeline* pipeline)
+{
+	AcquireSRWLockExclusive(&Lock);
+	const bool queued = pipeline->Queued;
+	if (queued)
+	{
+		Unlink(pipeline, Heads, Tails);
+	}
+	ReleaseSRWLockExclusive(&Lock);
+
+	if (!queued)
+	{
+		WaitUntilBuilt(pipeline);
+	}
+}
+
+void PipelineCompiler::Wait(GraphicsPipeline* pipeline)
+{
+	AcquireSRWLockExclusive(&Lock);
+	const bool queued = pipeline->Queued;
+	if (queued)
+	{
+		Unlink(pipeline, Heads, Tails);
+	}
+	ReleaseSRWLockExclusive(&Lock);
+
+	if (queued)
+	{
+		Build(pipeline);
+	}
+	else
+	{
+		WaitUntilBuilt(pipeline);
+	}
+}
+
+void PipelineCompiler::Run()
+{
+	while (true)
+	{
+		AcquireSRWLockExclusive(&Lock);
+
+		GraphicsPipeline* pipeline = nullptr;
+		while (!Exiting)
+		{
+			for (usize priority = PipelinePriorityCount; priority > 0 && !pipeline; --priority)
+			{
+				pipeline = Heads[priority - 1];
+			}
+			if (pipeline)
+			{
+				Unlink(pipeline, Heads, Tails);
+				break;
+			}
+			SleepConditionVariableSRW(&Available, &Lock, INFINITE, 0);
+		}
+
+		ReleaseSRWLockExclusive(&Lock);
+
+		if (!pipeline)
+		{
+			break;
+		}
+		Build(pipeline);
+	}
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Forward.hpp"
+
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+inline constexpr usize MaxPipelineCompileThreads = 8;
+inline constexpr usize PipelinePriorityCount = 3;
+
+// Builds pipelines created with Device::CreateAsync on a pool of worker threads, always taking the oldest pipeline of
+// the highest priority first.
+class PipelineCompiler final : public NoCopy
+{
+public:
+	explicit PipelineCompiler(Device* device);
+	~PipelineCompiler();
+
+	void Add(GraphicsPipeline* pipeline);
+
+	// Takes the pipeline out of the queue, or waits for the worker building it to finish.
+	void Remove(GraphicsPipeline* pipeline);
+
+	// Builds the pipeline on the calling thread if no worker has started it yet.
+	void Wait(GraphicsPipeline* pipeline);
+
+	void Run();
+
+	SRWLOCK Lock;
+	CONDITION_VARIABLE Available;
+	bool Exiting;
+
+	GraphicsPipeline* Heads[PipelinePriorityCount];
+	GraphicsPipeline* Tails[PipelinePriorityCount];
+
+	HANDLE Threads[MaxPipelineCompileThreads];
+	usize ThreadCount;
+
+	Device* Device;
+};
+
+}
@@ -0,0 +1,382 @@
+#include "PipelineLibrary.hpp"
+#include "Device.hpp"
+
+#include "RHI/Allocator.hpp"
+
+#include "Luft/Hash.hpp"
+
+#include <cwchar>
+
+namespace RHI::D3D12
+{
+
+static constexpr usize PrewarmedBucketCount = 256;
+
+// Combines a field's HashFnv1a with the hash of the fields before it.
+static uint64 HashPipelineBytes(uint64 hash, const void* data, usize size)
+{
+	const uint64 values[] = { hash, HashFnv1a(data, size) };
+	return HashFnv1a(values, sizeof(values));
+}
+
+template<typename T>
+static uint64 HashPipelineValue(uint64 hash, const T& value)
+{
+	return HashPipelineBytes(hash, &value, sizeof(value));
+}
+
+static uint64 HashPipelineBytecode(uint64 hash, const D3D12_SHADER_BYTECODE& bytecode)
+{
+	hash = HashPipelineValue(hash, bytecode.BytecodeLength);
+	return HashPipelineBytes(hash, bytecode.pShaderBytecode, bytecode.BytecodeLength);
+}
+
+// The blend and depth stencil descriptions end fields in single bytes followed by padding, so they are hashed field by
+// field like the input elements rather than as whole structs.
+static uint64 HashPipelineBlend(uint64 hash, const D3D12_BLEND_DESC& blend)
+{
+	hash = HashPipelineValue(hash, blend.AlphaToCoverageEnable);
+	hash = HashPipelineValue(hash, blend.IndependentBlendEnable);
+	for (const D3D12_RENDER_TARGET_BLEND_DESC& renderTarget : blend.RenderTarget)
+	{
+		hash = HashPipelineValue(hash, renderTarget.BlendEnable);
+		hash = HashPipelineValue(hash, renderTarget.LogicOpEnable);
+		hash = HashPipelineValue(hash, renderTarget.SrcBlend);
+		hash = HashPipelineValue(hash, renderTarget.DestBlend);
+		hash = HashPipelineValue(hash, renderTarget.BlendOp);
+		hash = HashPipelineValue(hash, renderTarget.SrcBlendAlpha);
+		hash = HashPipelineValue(hash, renderTarget.DestBlendAlpha);
+		hash = HashPipelineValue(hash, renderTarget.BlendOpAlpha);
+		hash = HashPipelineValue(hash, renderTarget.LogicOp);
+		hash = HashPipelineValue(hash, renderTarget.RenderTargetWriteMask);
+	}
+	return hash;
+}
+
+static uint64 HashPipelineDepthStencil(uint64 hash, const D3D12_DEPTH_STENCIL_DESC& depthStencil)
+{
+	hash = HashPipelineValue(hash, depthStencil.DepthEnable);
+	hash = HashPipelineValue(hash, depthStencil.DepthWriteMask);
+	hash = HashPipelineValue(hash, depthStencil.DepthFunc);
+	hash = HashPipelineValue(hash, depthStencil.StencilEnable);
+	hash = HashPipelineValue(hash, depthStencil.StencilReadMask);
+	hash = HashPipelineValue(hash, depthStencil.StencilWriteMask);
+	hash = HashPipelineValue(hash, depthStencil.FrontFace);
+	hash = HashPipelineValue(hash, depthStencil.BackFace);
+	return hash;
+}
+
+// Only values are hashed, never pointers or padding, so the same description hashes the same on every launch.
+static uint64 HashPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& description)
+{
+	uint64 hash = 0;
+	hash = HashPipelineBytecode(hash, description.VS);
+	hash = HashPipelineBytecode(hash, description.PS);
+	hash = HashPipelineBytecode(hash, description.DS);
+	hash = HashPipelineBytecode(hash, description.HS);
+	hash = HashPipelineBytecode(hash, description.GS);
+	hash = HashPipelineBlend(hash, description.BlendState);
+	hash = HashPipelineValue(hash, description.SampleMask);
+	hash = HashPipelineValue(hash, description.RasterizerState);
+	hash = HashPipelineDepthStencil(hash, description.DepthStencilState);
+
+	hash = HashPipelineValue(hash, description.InputLayout.NumElements);
+	for (uint32 i = 0; i < description.InputLayout.NumElements; ++i)
+	{
+		const D3D12_INPUT_ELEMENT_DESC& inputElement = description.InputLayout.pInputElementDescs[i];
+		hash = HashPipelineBytes(hash, inputElement.SemanticName, Platform::StringLength(inputElement.SemanticName));
+		hash = HashPipelineValue(hash, inputElement.SemanticIndex);
+		hash = HashPipelineValue(hash, inputElement.Format);
+		hash = HashPipelineValue(hash, inputElement.InputSlot);
+		hash = HashPipelineValue(hash, inputElement.AlignedByteOffset);
+		hash = HashPipelineValue(hash, inputElement.InputSlotClass);
+		hash = HashPipelineValue(hash, inputElement.InstanceDataStepRate);
+	}
+
+	hash = HashPipelineValue(hash, description.IBStripCutValue);
+	hash = HashPipelineValue(hash, description.PrimitiveTopologyType);
+	hash = HashPipelineValue(hash, description.NumRenderTargets);
+	hash = HashPipelineValue(hash, description.RTVFormats);
+	hash = HashPipelineValue(hash, description.DSVFormat);
+	hash = HashPipelineValue(hash, description.SampleDesc);
+	hash = HashPipelineValue(hash, description.Flags);
+	return hash;
+}
+
+static uint64 HashPipeline(const D3D12_COMPUTE_PIPELINE_STATE_DESC& description)
+{
+	uint64 hash = 0;
+	hash = HashPipelineBytecode(hash, description.CS);
+	hash = HashPipelineValue(hash, description.Flags);
+	return hash;
+}
+
+static void GetPipelineName(uint64 hash, wchar_t* name, usize nameLength)
+{
+	swprintf_s(name, nameLength, L"%016llx", static_cast<unsigned long long>(hash));
+}
+
+static LONG64 GetTicks()
+{
+	LARGE_INTEGER ticks;
+	QueryPerformanceCounter(&ticks);
+	return ticks.QuadPart;
+}
+
+PipelineLibrary::PipelineLibrary(StringView path, D3D12::Device* device)
+	: Path()
+	, Contents(Allocator)
+	, Native(nullptr)
+	, Hits(0)
+	, Misses(0)
+	, HitTicks(0)
+	, MissTicks(0)
+	, Stored(0)
+	, BytesRead(0)
+	, BytesWritten(0)
+	, PrewarmLock(SRWLOCK_INIT)
+	, Prewarming(false)
+	, Prewarmed(PrewarmedBucketCount, Allocator)
+	, PrewarmedCount(0)
+	, PrewarmedUsed(0)
+	, Late(0)
+	, Device(device)
+{
+	// Without a path pipelines are still created through here, so the statistics cover every launch.
+	if (path.GetLength() == 0)
+	{
+		return;
+	}
+	MultiByteToWideChar(CP_UTF8, 0, path.GetData(), static_cast<int32>(path.GetLength()), Path, MAX_PATH - 1);
+
+	const HANDLE file = CreateFileW(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		LARGE_INTEGER fileSize = {};
+		const bool validSize = GetFileSizeEx(file, &fileSize) != 0;
+		if (validSize)
+		{
+			Contents.GrowToLengthUninitialized(static_cast<usize>(fileSize.QuadPart));
+
+			DWORD bytesRead = 0;
+			const bool read = ::ReadFile(file, Contents.GetData(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr) &&
+							  bytesRead == static_cast<DWORD>(fileSize.QuadPart);
+			if (!read)
+			{
+				Contents = Array<uint8>(Allocator);
+			}
+		}
+		CloseHandle(file);
+	}
+
+	// A library written by another driver or adapter is rejected, and the pipelines are rebuilt into a fresh one.
+	HRESULT result = E_FAIL;
+	if (Contents.GetLength() > 0)
+	{
+		result = device->Native->CreatePipelineLibrary(Contents.GetData(), Contents.GetLength(), IID_PPV_ARGS(&Native));
+		BytesRead = SUCCEEDED(result) ? Contents.GetLength() : 0;
+	}
+	if (FAILED(result))
+	{
+		Contents = Array<uint8>(Allocator);
+		result = device->Native->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&Native));
+	}
+
+	// Some drivers do not support pipeline libraries at all, in which case every pipeline is a miss.
+	if (FAILED(result))
+	{
+		Native = nullptr;
+	}
+}
+
+PipelineLibrary::~PipelineLibrary()
+{
+	EndPrewarm();
+	for (auto& [_, pipelineState] : Prewarmed)
+	{
+		SAFE_RELEASE(pipelineState);
+	}
+
+	Save();
+	SAFE_RELEASE(Native);
+}
+
+void PipelineLibrary::Create(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState)
+{
+	const LONG64 start = GetTicks();
+
+	const uint64 hash = HashPipeline(description);
+	if (TakePrewarmed(hash, pipelineState))
+	{
+		return;
+	}
+
+	wchar_t name[17] = {};
+	GetPipelineName(hash, name, ARRAY_COUNT(name));
+
+	if (Native && SUCCEEDED(Native->LoadGraphicsPipeline(name, &description, IID_PPV_ARGS(pipelineState))))
+	{
+		InterlockedAdd64(&HitTicks, GetTicks() - start);
+		InterlockedIncrement64(&Hits);
+		KeepPrewarmed(hash, *pipelineState);
+		return;
+	}
+
+	CHECK_RESULT(Device->Native->CreateGraphicsPipelineState(&description, IID_PPV_ARGS(pipelineState)));
+	if (Native && SUCCEEDED(Native->StorePipeline(name, *pipelineState)))
+	{
+		InterlockedIncrement64(&Stored);
+	}
+
+	InterlockedAdd64(&MissTicks, GetTicks() - start);
+	InterlockedIncrement64(&Misses);
+	KeepPrewarmed(hash, *pipelineState);
+}
+
+void PipelineLibrary::Create(const D3D12_COMPUTE_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState)
+{
+	const LONG64 start = GetTicks();
+
+	const uint64 hash = HashPipeline(description);
+	if (TakePrewarmed(hash, pipelineState))
+	{
+		return;
+	}
+
+	wchar_t name[17] = {};
+	GetPipelineName(hash, name, ARRAY_COUNT(name));
+
+	if (Native && SUCCEEDED(Native->LoadComputePipeline(name, &description, IID_PPV_ARGS(pipelineState))))
+	{
+		InterlockedAdd64(&HitTicks, GetTicks() - start);
+		InterlockedIncrement64(&Hits);
+		KeepPrewarmed(hash, *pipelineState);
+		return;
+	}
+
+	CHECK_RESULT(Device->Native->CreateComputePipelineState(&description, IID_PPV_ARGS(pipelineState)));
+	if (Native && SUCCEEDED(Native->StorePipeline(name, *pipelineState)))
+	{
+		InterlockedIncrement64(&Stored);
+	}
+
+	InterlockedAdd64(&MissTicks, GetTicks() - start);
+	InterlockedIncrement64(&Misses);
+	KeepPrewarmed(hash, *pipelineState);
+}
+
+void PipelineLibrary::Save()
+{
+	if (!Native || Stored == 0 || Path[0] == L'\0')
+	{
+		return;
+	}
+
+	Array<uint8> serialized(Allocator);
+	serialized.GrowToLengthUninitialized(Native->GetSerializedSize());
+	if (FAILED(Native->Serialize(serialized.GetData(), serialized.GetLength())))
+	{
+		return;
+	}
+
+	wchar_t temporaryPath[MAX_PATH] = {};
+	swprintf_s(temporaryPath, ARRAY_COUNT(temporaryPath), L"%s.tmp", Path);
+
+	const HANDLE file = CreateFileW(temporaryPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	DWORD bytesWritten = 0;
+	const bool written = ::WriteFile(file, serialized.GetData(), static_cast<DWORD>(serialized.GetLength()), &bytesWritten, nullptr) &&
+						 bytesWritten == serialized.GetLength();
+	CloseHandle(file);
+
+	if (written && MoveFileExW(temporaryPath, Path, MOVEFILE_REPLACE_EXISTING))
+	{
+		BytesWritten += bytesWritten;
+		Stored = 0;
+	}
+	else
+	{
+		DeleteFileW(temporaryPath);
+	}
+}
+
+void PipelineLibrary::BeginPrewarm()
+{
+	AcquireSRWLockExclusive(&PrewarmLock);
+	Prewarming = true;
+	ReleaseSRWLockExclusive(&PrewarmLock);
+}
+
+void PipelineLibrary::EndPrewarm()
+{
+	AcquireSRWLockExclusive(&PrewarmLock);
+	Prewarming = false;
+	ReleaseSRWLockExclusive(&PrewarmLock);
+}
+
+bool PipelineLibrary::TakePrewarmed(uint64 hash, ID3D12PipelineState** pipelineState)
+{
+	AcquireSRWLockExclusive(&PrewarmLock);
+	const bool prewarming = Prewarming;
+	const bool found = !prewarming && Prewarmed.Contains(hash) && Prewarmed[hash];
+	if (found)
+	{
+		// The reference the prewarmed table held now belongs to the new pipeline.
+		*pipelineState = Prewarmed[hash];
+		Prewarmed[hash] = nullptr;
+	}
+	ReleaseSRWLockExclusive(&PrewarmLock);
+
+	if (found)
+	{
+		InterlockedIncrement64(&PrewarmedUsed);
+	}
+	else if (!prewarming)
+	{
+		InterlockedIncrement64(&Late);
+	}
+	return found;
+}
+
+void PipelineLibrary::KeepPrewarmed(uint64 hash, ID3D12PipelineState* pipelineState)
+{
+	AcquireSRWLockExclusive(&PrewarmLock);
+	const bool keep = Prewarming && !Prewarmed.Contains(hash);
+	if (keep)
+	{
+		pipelineState->AddRef();
+		Prewarmed.Add(hash, pipelineState);
+	}
+	ReleaseSRWLockExclusive(&PrewarmLock);
+
+	if (keep)
+	{
+		InterlockedIncrement64(&PrewarmedCount);
+	}
+}
+
+PipelineCacheStatistics PipelineLibrary::GetStatistics() const
+{
+	return PipelineCacheStatistics
+	{
+		.Hits = static_cast<usize>(Hits),
+		.Misses = static_cast<usize>(Misses),
+		.HitTime = static_cast<double>(HitTicks) / Device->PerformanceCounterFrequency,
+		.MissTime = static_cast<double>(MissTicks) / Device->PerformanceCounterFrequency,
+		.BytesRead = BytesRead,
+		.BytesWritten = BytesWritten,
+	};
+}
+
+void PipelineLibrary::GetWarmUpStatistics(PipelineWarmUpStatistics* statistics) const
+{
+	statistics->Prewarmed = static_cast<usize>(PrewarmedCount);
+	statistics->PrewarmedUsed = static_cast<usize>(PrewarmedUsed);
+	statistics->Late = static_cast<usize>(Late);
+}
+
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Forward.hpp"
+
+#include "Luft/Array.hpp"
+#include "Luft/HashTable.hpp"
+#include "Luft/NoCopy.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI::D3D12
+{
+
+// Wraps the driver's pipeline library. Pipelines are stored under a hash of everything that goes into their state
+// description, so a later launch with the same shaders and state skips the driver compile.
+class PipelineLibrary final : public NoCopy
+{
+public:
+	PipelineLibrary(StringView path, Device* device);
+	~PipelineLibrary();
+
+	void Create(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState);
+	void Create(const D3D12_COMPUTE_PIPELINE_STATE_DESC& description, ID3D12PipelineState** pipelineState);
+
+	void Save();
+
+	// While prewarming, every pipeline created is also kept, and the first pipeline created later with the same hash
+	// takes it over instead of going to the driver.
+	void BeginPrewarm();
+	void EndPrewarm();
+
+	bool TakePrewarmed(uint64 hash, ID3D12PipelineState** pipelineState);
+	void KeepPrewarmed(uint64 hash, ID3D12PipelineState* pipelineState);
+
+	PipelineCacheStatistics GetStatistics() const;
+	void GetWarmUpStatistics(PipelineWarmUpStatistics* statistics) const;
+
+	wchar_t Path[MAX_PATH];
+
+	// The driver reads from this memory for as long as the library exists.
+	Array<uint8> Contents;
+	ID3D12PipelineLibrary1* Native;
+
+	volatile LONG64 Hits;
+	volatile LONG64 Misses;
+	volatile LONG64 HitTicks;
+	volatile LONG64 MissTicks;
+	volatile LONG64 Stored;
+	usize BytesRead;
+	usize BytesWritten;
+
+	SRWLOCK PrewarmLock;
+	bool Prewarming;
+	HashTable<uint64, ID3D12PipelineState*> Prewarmed;
+	volatile LONG64 PrewarmedCount;
+	volatile LONG64 PrewarmedUsed;
+	volatile LONG64 Late;
+
+	Device* Device;
+};
+
+}
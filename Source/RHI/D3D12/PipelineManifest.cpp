@@ -0,0 +1,635 @@
+#include "PipelineManifest.hpp"
+#include "ComputePipeline.hpp"
+#include "Device.hpp"
+#include "GraphicsPipeline.hpp"
+#include "Shader.hpp"
+
+#include "RHI/Allocator.hpp"
+
+#include "Luft/Hash.hpp"
+
+#include <cwchar>
+
+namespace RHI::D3D12
+{
+
+static constexpr uint32 ManifestMagic = 0x4D505248;
+static constexpr uint32 ManifestVersion = 5;
+
+static constexpr usize RecordedBucketCount = 256;
+static constexpr usize ShaderBucketCount = 256;
+
+static constexpr usize RenderTargetRecordSize = 3;
+static constexpr usize GraphicsStateRecordSize = 7 + 3 * sizeof(uint32);
+
+// Records are a kind byte followed by the description. Strings are a uint16 length and their bytes, and graphics and
+// compute records store their shaders inline, so every record can be read on its own. Graphics records store three
+// bytes per render target, a fixed block of state, then the vertex attribute overrides.
+enum class ManifestRecord : uint8
+{
+	Shader,
+	GraphicsPipeline,
+	ComputePipeline,
+};
+
+struct ManifestHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint64 RecordsSize;
+};
+
+struct ManifestReader
+{
+	const uint8* Cursor;
+	const uint8* End;
+	bool Valid;
+};
+
+static void WriteByte(Array<uint8>* output, uint8 value)
+{
+	output->Add(value);
+}
+
+static void WriteUInt32(Array<uint8>* output, uint32 value)
+{
+	for (usize i = 0; i < sizeof(value); ++i)
+	{
+		WriteByte(output, static_cast<uint8>(value >> (i * 8)));
+	}
+}
+
+static void WriteFloat(Array<uint8>* output, float value)
+{
+	uint32 bits = 0;
+	Platform::MemoryCopy(&bits, &value, sizeof(bits));
+	WriteUInt32(output, bits);
+}
+
+static void WriteString(Array<uint8>* output, StringView string)
+{
+	CHECK(string.GetLength() <= UINT16_MAX);
+	const uint16 length = static_cast<uint16>(string.GetLength());
+	WriteByte(output, static_cast<uint8>(length & 0xFF));
+	WriteByte(output, static_cast<uint8>(length >> 8));
+	for (usize i = 0; i < length; ++i)
+	{
+		WriteByte(output, static_cast<uint8>(string.GetData()[i]));
+	}
+}
+
+static void WriteShader(Array<uint8>* output, const ShaderDescription& description)
+{
+	CHECK(description.Defines.GetLength() <= UINT8_MAX);
+	WriteString(output, description.FilePath);
+	WriteByte(output, static_cast<uint8>(description.Stage));
+	WriteByte(output, static_cast<uint8>(description.Defines.GetLength()));
+	for (const ShaderDefine& define : description.Defines)
+	{
+		WriteString(output, define.Name);
+		WriteString(output, define.Value);
+	}
+}
+
+static uint8 ReadByte(ManifestReader* reader)
+{
+	reader->Valid = reader->Valid && reader->Cursor < reader->End;
+	return reader->Valid ? *reader->Cursor++ : 0;
+}
+
+static uint32 ReadUInt32(ManifestReader* reader)
+{
+	uint32 value = 0;
+	for (usize i = 0; i < sizeof(value); ++i)
+	{
+		value |= static_cast<uint32>(ReadByte(reader)) << (i * 8);
+	}
+	return value;
+}
+
+static float ReadFloat(ManifestReader* reader)
+{
+	const uint32 bits = ReadUInt32(reader);
+	float value = 0.0f;
+	Platform::MemoryCopy(&value, &bits, sizeof(value));
+	return value;
+}
+
+static void SkipBytes(ManifestReader* reader, usize count)
+{
+	for (usize i = 0; i < count; ++i)
+	{
+		ReadByte(reader);
+	}
+}
+
+static StringView ReadString(ManifestReader* reader)
+{
+	const uint8 low = ReadByte(reader);
+	const uint8 high = ReadByte(reader);
+	const uint16 length = static_cast<uint16>(low | (high << 8));
+	reader->Valid = reader->Valid && static_cast<usize>(reader->End - reader->Cursor) >= length;
+	if (!reader->Valid)
+	{
+		return StringView();
+	}
+
+	const StringView string(reinterpret_cast<const char*>(reader->Cursor), length);
+	reader->Cursor += length;
+	return string;
+}
+
+// Without an attributes array this only skips over them.
+static void ReadVertexAttributes(ManifestReader* reader, Array<VertexAttribute>* attributes)
+{
+	const usize attributeCount = ReadByte(reader);
+	for (usize i = 0; i < attributeCount; ++i)
+	{
+		const StringView semantic = ReadString(reader);
+		const uint32 semanticIndex = ReadByte(reader);
+		const VertexFormat format = static_cast<VertexFormat>(ReadByte(reader));
+		const bool placed = ReadByte(reader) != 0;
+		const uint32 stream = ReadByte(reader);
+		const uint32 offset = ReadUInt32(reader);
+		if (attributes)
+		{
+			attributes->Add(VertexAttribute
+			{
+				.Semantic = semantic,
+				.SemanticIndex = semanticIndex,
+				.Format = format,
+				.Placed = placed,
+				.Stream = stream,
+				.Offset = offset,
+			});
+		}
+	}
+}
+
+// Without a defines array this only skips over the shader.
+static ShaderDescription ReadShader(ManifestReader* reader, Array<ShaderDefine>* defines)
+{
+	ShaderDescription description = {};
+	description.FilePath = ReadString(reader);
+	description.Stage = static_cast<ShaderStage>(ReadByte(reader));
+
+	const usize defineCount = ReadByte(reader);
+	const usize firstDefine = defines ? defines->GetLength() : 0;
+	for (usize i = 0; i < defineCount; ++i)
+	{
+		const StringView name = ReadString(reader);
+		const StringView value = ReadString(reader);
+		if (defines)
+		{
+			defines->Add(ShaderDefine { .Name = name, .Value = value });
+		}
+	}
+
+	if (defines && reader->Valid)
+	{
+		description.Defines = ArrayView<const ShaderDefine>(defines->GetData() + firstDefine, defineCount);
+	}
+	return description;
+}
+
+PipelineManifest::PipelineManifest(StringView path)
+	: Path()
+	, Loaded(Allocator)
+	, Records(Allocator)
+	, Recorded(RecordedBucketCount, Allocator)
+	, Changed(false)
+{
+	MultiByteToWideChar(CP_UTF8, 0, path.GetData(), static_cast<int32>(path.GetLength()), Path, MAX_PATH - 1);
+
+	const HANDLE file = CreateFileW(Path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	bool read = GetFileSizeEx(file, &fileSize) != 0 && static_cast<usize>(fileSize.QuadPart) >= sizeof(ManifestHeader);
+	if (read)
+	{
+		Loaded.GrowToLengthUninitialized(static_cast<usize>(fileSize.QuadPart));
+
+		DWORD bytesRead = 0;
+		read = ::ReadFile(file, Loaded.GetData(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr) &&
+			   bytesRead == static_cast<DWORD>(fileSize.QuadPart);
+	}
+	CloseHandle(file);
+
+	ManifestHeader header = {};
+	if (read)
+	{
+		Platform::MemoryCopy(&header, Loaded.GetData(), sizeof(header));
+	}
+
+	// A manifest from another version is dropped and recorded again from scratch.
+	const bool valid = read &&
+					   header.Magic == ManifestMagic &&
+					   header.Version == ManifestVersion &&
+					   header.RecordsSize == Loaded.GetLength() - sizeof(header);
+	if (!valid)
+	{
+		Loaded = Array<uint8>(Allocator);
+		return;
+	}
+
+	ManifestReader reader =
+	{
+		.Cursor = Loaded.GetData() + sizeof(header),
+		.End = Loaded.GetData() + Loaded.GetLength(),
+		.Valid = true,
+	};
+	while (reader.Valid && reader.Cursor < reader.End)
+	{
+		const uint8* record = reader.Cursor;
+		switch (static_cast<ManifestRecord>(ReadByte(&reader)))
+		{
+		case ManifestRecord::Shader:
+			ReadShader(&reader, nullptr);
+			break;
+		case ManifestRecord::GraphicsPipeline:
+		{
+			const usize stageCount = ReadByte(&reader);
+			reader.Valid = reader.Valid && stageCount >= 1 && stageCount <= 2;
+			for (usize i = 0; i < stageCount; ++i)
+			{
+				ReadShader(&reader, nullptr);
+			}
+			const usize renderTargetCount = ReadByte(&reader);
+			reader.Valid = reader.Valid && renderTargetCount <= MaxRenderTargetCount;
+			SkipBytes(&reader, renderTargetCount * RenderTargetRecordSize + GraphicsStateRecordSize);
+			ReadVertexAttributes(&reader, nullptr);
+			ReadString(&reader);
+			break;
+		}
+		case ManifestRecord::ComputePipeline:
+			ReadShader(&reader, nullptr);
+			ReadString(&reader);
+			break;
+		default:
+			reader.Valid = false;
+			break;
+		}
+
+		if (reader.Valid)
+		{
+			const uint64 hash = HashFnv1a(record, reader.Cursor - record);
+			if (!Recorded.Contains(hash))
+			{
+				Recorded.Add(hash, true);
+				for (const uint8* byte = record; byte < reader.Cursor; ++byte)
+				{
+					Records.Add(*byte);
+				}
+			}
+		}
+	}
+
+	if (!reader.Valid)
+	{
+		Loaded = Array<uint8>(Allocator);
+		Records = Array<uint8>(Allocator);
+		Recorded = HashTable<uint64, bool>(RecordedBucketCount, Allocator);
+	}
+}
+
+PipelineManifest::~PipelineManifest()
+{
+	Save();
+}
+
+static void AddRecord(const Array<uint8>& record,
+					  Array<uint8>* records,
+					  HashTable<uint64, bool>* recorded,
+					  bool* changed)
+{
+	const uint64 hash = HashFnv1a(record.GetData(), record.GetLength());
+	if (recorded->Contains(hash))
+	{
+		return;
+	}
+
+	recorded->Add(hash, true);
+	for (const uint8 byte : record)
+	{
+		records->Add(byte);
+	}
+	*changed = true;
+}
+
+void PipelineManifest::Record(const ShaderDescription& description)
+{
+	Array<uint8> record(Allocator);
+	WriteByte(&record, static_cast<uint8>(ManifestRecord::Shader));
+	WriteShader(&record, description);
+	AddRecord(record, &Records, &Recorded, &Changed);
+}
+
+void PipelineManifest::Record(const GraphicsPipelineDescription& description)
+{
+	Array<uint8> record(Allocator);
+	WriteByte(&record, static_cast<uint8>(ManifestRecord::GraphicsPipeline));
+
+	WriteByte(&record, static_cast<uint8>(description.Stages.GetCount()));
+	for (const auto& [_, shader] : description.Stages)
+	{
+		WriteShader(&record, shader);
+	}
+
+	// Pipelines without per-target blends are recorded with the default blend spelled out, which builds the same state.
+	const usize renderTargetCount = description.RenderTargetFormats.GetLength();
+	WriteByte(&record, static_cast<uint8>(renderTargetCount));
+	for (usize i = 0; i < renderTargetCount; ++i)
+	{
+		const RenderTargetBlend blend = i < description.RenderTargetBlends.GetLength() ? description.RenderTargetBlends[i]
+																						 : RenderTargetBlend {};
+		WriteByte(&record, static_cast<uint8>(description.RenderTargetFormats[i]));
+		WriteByte(&record, static_cast<uint8>(blend.Blend));
+		WriteByte(&record, static_cast<uint8>(blend.Write));
+	}
+	WriteByte(&record, static_cast<uint8>(description.DepthStencilFormat));
+	WriteByte(&record, description.AlphaBlend);
+	WriteByte(&record, description.ReverseDepth);
+	WriteByte(&record, static_cast<uint8>(description.CullMode));
+	WriteByte(&record, static_cast<uint8>(description.DepthFunction));
+	WriteByte(&record, description.DisableDepthWrite);
+	WriteByte(&record, static_cast<uint8>(description.PrimitiveTopology));
+	WriteUInt32(&record, static_cast<uint32>(description.DepthBias.Constant));
+	WriteFloat(&record, description.DepthBias.SlopeScaled);
+	WriteFloat(&record, description.DepthBias.Clamp);
+
+	CHECK(description.VertexAttributes.GetLength() <= UINT8_MAX);
+	WriteByte(&record, static_cast<uint8>(description.VertexAttributes.GetLength()));
+	for (const VertexAttribute& attribute : description.VertexAttributes)
+	{
+		CHECK(attribute.SemanticIndex <= UINT8_MAX && attribute.Stream <= UINT8_MAX);
+		WriteString(&record, attribute.Semantic);
+		WriteByte(&record, static_cast<uint8>(attribute.SemanticIndex));
+		WriteByte(&record, static_cast<uint8>(attribute.Format));
+		WriteByte(&record, attribute.Placed);
+		WriteByte(&record, static_cast<uint8>(attribute.Stream));
+		WriteUInt32(&record, attribute.Offset);
+	}
+	WriteString(&record, description.Name);
+
+	AddRecord(record, &Records, &Recorded, &Changed);
+}
+
+void PipelineManifest::Record(const ComputePipelineDescription& description)
+{
+	Array<uint8> record(Allocator);
+	WriteByte(&record, static_cast<uint8>(ManifestRecord::ComputePipeline));
+	WriteShader(&record, description.Stage);
+	WriteString(&record, description.Name);
+	AddRecord(record, &Records, &Recorded, &Changed);
+}
+
+void PipelineManifest::Replay(D3D12::Device* device)
+{
+	if (Loaded.GetLength() == 0)
+	{
+		return;
+	}
+
+	// The first pass counts defines so the second can point descriptions into an array that never reallocates.
+	usize defineCount = 0;
+	usize recordCount = 0;
+	{
+		Array<ShaderDefine> scratch(Allocator);
+		ManifestReader reader = { Loaded.GetData() + sizeof(ManifestHeader), Loaded.GetData() + Loaded.GetLength(), true };
+		while (reader.Cursor < reader.End)
+		{
+			const ManifestRecord kind = static_cast<ManifestRecord>(ReadByte(&reader));
+			const usize shaderCount = kind == ManifestRecord::GraphicsPipeline ? ReadByte(&reader) : 1;
+			for (usize i = 0; i < shaderCount; ++i)
+			{
+				ReadShader(&reader, &scratch);
+			}
+			if (kind == ManifestRecord::GraphicsPipeline)
+			{
+				const usize renderTargetCount = ReadByte(&reader);
+				SkipBytes(&reader, renderTargetCount * RenderTargetRecordSize + GraphicsStateRecordSize);
+				ReadVertexAttributes(&reader, nullptr);
+			}
+			if (kind != ManifestRecord::Shader)
+			{
+				ReadString(&reader);
+			}
+			++recordCount;
+		}
+		defineCount = scratch.GetLength();
+	}
+
+	Array<ShaderDefine> defines(defineCount, Allocator);
+	Array<ShaderDescription> shaderDescriptions(Allocator);
+	HashTable<uint64, usize> shaderIndices(ShaderBucketCount, Allocator);
+
+	struct Pending
+	{
+		ManifestRecord Kind;
+		usize Shaders[2];
+		usize ShaderCount;
+		usize FirstRenderTarget;
+		usize RenderTargetCount;
+		ResourceFormat DepthStencilFormat;
+		bool AlphaBlend;
+		bool ReverseDepth;
+		CullMode CullMode;
+		ComparisonFunction DepthFunction;
+		bool DisableDepthWrite;
+		PrimitiveTopology PrimitiveTopology;
+		DepthBias DepthBias;
+		usize FirstVertexAttribute;
+		usize VertexAttributeCount;
+		StringView Name;
+	};
+	Array<Pending> pending(recordCount, Allocator);
+	Array<ResourceFormat> formats(Allocator);
+	Array<RenderTargetBlend> blends(Allocator);
+	Array<VertexAttribute> vertexAttributes(Allocator);
+
+	ManifestReader reader = { Loaded.GetData() + sizeof(ManifestHeader), Loaded.GetData() + Loaded.GetLength(), true };
+	while (reader.Cursor < reader.End)
+	{
+		Pending record = {};
+		record.Kind = static_cast<ManifestRecord>(ReadByte(&reader));
+		record.ShaderCount = record.Kind == ManifestRecord::GraphicsPipeline ? ReadByte(&reader) : 1;
+		for (usize i = 0; i < record.ShaderCount; ++i)
+		{
+			const uint8* shaderStart = reader.Cursor;
+			const ShaderDescription description = ReadShader(&reader, &defines);
+
+			const uint64 hash = HashFnv1a(shaderStart, reader.Cursor - shaderStart);
+			if (!shaderIndices.Contains(hash))
+			{
+				shaderIndices.Add(hash, shaderDescriptions.GetLength());
+				shaderDescriptions.Add(description);
+			}
+			record.Shaders[i] = shaderIndices[hash];
+		}
+
+		if (record.Kind == ManifestRecord::GraphicsPipeline)
+		{
+			record.RenderTargetCount = ReadByte(&reader);
+			record.FirstRenderTarget = formats.GetLength();
+			for (usize i = 0; i < record.RenderTargetCount; ++i)
+			{
+				formats.Add(static_cast<ResourceFormat>(ReadByte(&reader)));
+				const BlendMode blend = static_cast<BlendMode>(ReadByte(&reader));
+				const ColorWrite write = static_cast<ColorWrite>(ReadByte(&reader));
+				blends.Add(RenderTargetBlend { .Blend = blend, .Write = write });
+			}
+			record.DepthStencilFormat = static_cast<ResourceFormat>(ReadByte(&reader));
+			record.AlphaBlend = ReadByte(&reader) != 0;
+			record.ReverseDepth = ReadByte(&reader) != 0;
+			record.CullMode = static_cast<CullMode>(ReadByte(&reader));
+			record.DepthFunction = static_cast<ComparisonFunction>(ReadByte(&reader));
+			record.DisableDepthWrite = ReadByte(&reader) != 0;
+			record.PrimitiveTopology = static_cast<PrimitiveTopology>(ReadByte(&reader));
+			record.DepthBias.Constant = static_cast<int32>(ReadUInt32(&reader));
+			record.DepthBias.SlopeScaled = ReadFloat(&reader);
+			record.DepthBias.Clamp = ReadFloat(&reader);
+			record.FirstVertexAttribute = vertexAttributes.GetLength();
+			ReadVertexAttributes(&reader, &vertexAttributes);
+			record.VertexAttributeCount = vertexAttributes.GetLength() - record.FirstVertexAttribute;
+		}
+		if (record.Kind != ManifestRecord::Shader)
+		{
+			record.Name = ReadString(&reader);
+		}
+		pending.Add(record);
+	}
+
+	// Every shader compiles in parallel first, which also warms the shader cache for the ones no pipeline uses.
+	Array<Shader*> shaders(shaderDescriptions.GetLength(), Allocator);
+	shaders.GrowToLengthUninitialized(shaderDescriptions.GetLength());
+	Array<String> errors(shaderDescriptions.GetLength(), Allocator);
+	for (usize i = 0; i < shaderDescriptions.GetLength(); ++i)
+	{
+		errors.Add(String(0, Allocator));
+	}
+	if (shaderDescriptions.GetLength() > 0)
+	{
+		device->Create(ArrayView<const ShaderDescription>(shaderDescriptions.GetData(), shaderDescriptions.GetLength()),
+					   shaders.GetData(),
+					   errors.GetData());
+	}
+
+	Array<GraphicsPipeline*> graphicsPipelines(Allocator);
+	Array<ComputePipeline*> computePipelines(Allocator);
+	for (const Pending& record : pending)
+	{
+		bool compiled = true;
+		for (usize i = 0; i < record.ShaderCount; ++i)
+		{
+			compiled = compiled && shaders[record.Shaders[i]];
+		}
+		if (!compiled || record.Kind == ManifestRecord::Shader)
+		{
+			continue;
+		}
+
+		if (record.Kind == ManifestRecord::GraphicsPipeline)
+		{
+			GraphicsPipelineDescription description = {};
+			for (usize i = 0; i < record.ShaderCount; ++i)
+			{
+				const usize shaderIndex = record.Shaders[i];
+				description.Stages.AddStage(RHI::Shader(shaderDescriptions[shaderIndex], shaders[shaderIndex]));
+			}
+			description.RenderTargetFormats = ArrayView<const ResourceFormat>(formats.GetData() + record.FirstRenderTarget,
+																			 record.RenderTargetCount);
+			description.RenderTargetBlends = ArrayView<const RenderTargetBlend>(blends.GetData() + record.FirstRenderTarget,
+																				record.RenderTargetCount);
+			description.DepthStencilFormat = record.DepthStencilFormat;
+			description.AlphaBlend = record.AlphaBlend;
+			description.ReverseDepth = record.ReverseDepth;
+			description.CullMode = record.CullMode;
+			description.DepthFunction = record.DepthFunction;
+			description.DisableDepthWrite = record.DisableDepthWrite;
+			description.DepthBias = record.DepthBias;
+			description.PrimitiveTopology = record.PrimitiveTopology;
+			description.VertexAttributes = ArrayView<const VertexAttribute>(vertexAttributes.GetData() + record.FirstVertexAttribute,
+																			record.VertexAttributeCount);
+			description.Name = record.Name;
+			graphicsPipelines.Add(device->CreateAsync(description, PipelinePriority::High, nullptr));
+		}
+		else
+		{
+			const usize shaderIndex = record.Shaders[0];
+			computePipelines.Add(device->Create(ComputePipelineDescription
+			{
+				.Stage = RHI::Shader(shaderDescriptions[shaderIndex], shaders[shaderIndex]),
+				.Name = record.Name,
+			}));
+		}
+	}
+
+	// Waiting also builds on this thread, so it helps the workers instead of idling.
+	for (GraphicsPipeline* graphicsPipeline : graphicsPipelines)
+	{
+		device->WaitForPipeline(graphicsPipeline);
+	}
+
+	// The pipeline library keeps the built pipeline states, so the objects used to build them can go.
+	for (GraphicsPipeline* graphicsPipeline : graphicsPipelines)
+	{
+		device->Destroy(graphicsPipeline);
+	}
+	for (ComputePipeline* computePipeline : computePipelines)
+	{
+		device->Destroy(computePipeline);
+	}
+	for (Shader* shader : shaders)
+	{
+		if (shader)
+		{
+			device->Destroy(shader);
+		}
+	}
+}
+
+void PipelineManifest::Save()
+{
+	if (!Changed || Path[0] == L'\0')
+	{
+		return;
+	}
+
+	const ManifestHeader header =
+	{
+		.Magic = ManifestMagic,
+		.Version = ManifestVersion,
+		.RecordsSize = Records.GetLength(),
+	};
+
+	wchar_t temporaryPath[MAX_PATH] = {};
+	swprintf_s(temporaryPath, ARRAY_COUNT(temporaryPath), L"%s.tmp", Path);
+
+	const HANDLE file = CreateFileW(temporaryPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	DWORD headerBytesWritten = 0;
+	DWORD recordBytesWritten = 0;
+	const bool written = ::WriteFile(file, &header, sizeof(header), &headerBytesWritten, nullptr) &&
+						 ::WriteFile(file, Records.GetData(), static_cast<DWORD>(Records.GetLength()), &recordBytesWritten, nullptr) &&
+						 recordBytesWritten == Records.GetLength();
+	CloseHandle(file);
+
+	if (written && MoveFileExW(temporaryPath, Path, MOVEFILE_REPLACE_EXISTING))
+	{
+		Changed = false;
+	}
+	else
+	{
+		DeleteFileW(temporaryPath);
+	}
+}
+
+}
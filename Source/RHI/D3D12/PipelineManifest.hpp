@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Forward.hpp"
+
+#include "Luft/Array.hpp"
+#include "Luft/HashTable.hpp"
+#include "Luft/NoCopy.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI::D3D12
+{
+
+// Records every shader and pipeline description created in a session, and replays the ones recorded in earlier
+// sessions so their pipelines are built before they are first needed. The file is rewritten when the device is
+// destroyed if anything new was recorded.
+class PipelineManifest final : public NoCopy
+{
+public:
+	explicit PipelineManifest(StringView path);
+	~PipelineManifest();
+
+	void Record(const ShaderDescription& description);
+	void Record(const GraphicsPipelineDescription& description);
+	void Record(const ComputePipelineDescription& description);
+
+	void Replay(Device* device);
+	void Save();
+
+	wchar_t Path[MAX_PATH];
+
+	// Loaded from disk and only read by Replay. The descriptions it builds point into this memory.
+	Array<uint8> Loaded;
+
+	Array<uint8> Records;
+	HashTable<uint64, bool> Recorded;
+	bool Changed;
+};
+
+}
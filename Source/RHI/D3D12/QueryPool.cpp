@@ -0,0 +1,23 @@
+#include "QueryPool.hpp"
+#include "Convert.hpp"
+#include "Device.hpp"
+
+namespace RHI::D3D12
+{
+
+QueryPool::QueryPool(const QueryPoolDescription& description, const D3D12::Device* device)
+	: QueryPoolDescription(description)
+{
+	CHECK(Count > 0);
+
+	const D3D12_QUERY_HEAP_DESC nativeDescription = To(description);
+	CHECK_RESULT(device->Native->CreateQueryHeap(&nativeDescription, IID_PPV_ARGS(&Native)));
+	SET_D3D_NAME(Native, Name);
+}
+
+QueryPool::~QueryPool()
+{
+	SAFE_RELEASE(Native);
+}
+
+}
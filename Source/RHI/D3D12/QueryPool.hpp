@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/QueryPool.hpp"
+
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+class QueryPool final : public QueryPoolDescription, NoCopy
+{
+public:
+	QueryPool(const QueryPoolDescription& description, const Device* device);
+	~QueryPool();
+
+	ID3D12QueryHeap* Native;
+};
+
+}
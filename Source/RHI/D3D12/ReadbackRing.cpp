@@ -0,0 +1,146 @@
+#include "ReadbackRing.hpp"
+#include "Device.hpp"
+#include "Fence.hpp"
+#include "Resource.hpp"
+
+namespace RHI::D3D12
+{
+
+static bool Overlaps(const ReadbackTicket& ticket, usize offset, usize size)
+{
+	return offset < ticket.Offset + ticket.Size && ticket.Offset < offset + size;
+}
+
+ReadbackRing::ReadbackRing(const ReadbackRingDescription& description, D3D12::Device* device)
+	: ReadbackRingDescription(description)
+	, Mapped(nullptr)
+	, Head(0)
+	, Pending()
+	, PendingStart(0)
+	, PendingCount(0)
+	, Device(device)
+{
+	CHECK(Size > 0);
+
+	Buffer = Device->Create(
+	{
+		.Type = ResourceType::Buffer,
+		.Format = ResourceFormat::None,
+		.Flags = ResourceFlags::ReadBack,
+		.InitialLayout = BarrierLayout::Undefined,
+		.Size = Size,
+		.Name = Name,
+	});
+	CHECK_RESULT(Buffer->Native->Map(0, ReadEverything, reinterpret_cast<void**>(&Mapped)));
+}
+
+ReadbackRing::~ReadbackRing()
+{
+	Buffer->Native->Unmap(0, &WriteNothing);
+	Mapped = nullptr;
+
+	Device->Destroy(Buffer);
+	Buffer = nullptr;
+}
+
+ReadbackTicket ReadbackRing::Allocate(usize size, usize alignment)
+{
+	CHECK(size <= Size);
+
+	usize offset = (Head + alignment - 1) / alignment * alignment;
+	if (offset + size > Size)
+	{
+		offset = 0;
+	}
+
+	const uint64 fenceValue = Device->FrameFenceValues[Device->GetFrameIndex()];
+
+	// Any pending ticket can overlap the new range once the ring has wrapped, not just the oldest. Tickets are pending in
+	// fence order, so waiting for the newest one that overlaps or is ready retires every older ticket along with it.
+	usize retireCount = 0;
+	for (usize i = 0; i < PendingCount; ++i)
+	{
+		const ReadbackTicket& pending = Pending[(PendingStart + i) % MaxPendingReadbacks];
+		if (IsReady(pending) || Overlaps(pending, offset, size))
+		{
+			retireCount = i + 1;
+		}
+	}
+
+	if (retireCount > 0)
+	{
+		const ReadbackTicket& newest = Pending[(PendingStart + retireCount - 1) % MaxPendingReadbacks];
+		VERIFY(newest.FenceValue < fenceValue, "Readback ring is too small for one frame of readbacks!");
+		Wait(newest);
+
+		PendingStart = (PendingStart + retireCount) % MaxPendingReadbacks;
+		PendingCount -= retireCount;
+	}
+
+	const ReadbackTicket ticket =
+	{
+		.Offset = offset,
+		.Size = size,
+		.FenceValue = fenceValue,
+		.RowPitch = static_cast<uint32>(size),
+		.RowSize = static_cast<uint32>(size),
+		.RowCount = 1,
+	};
+
+	// Readbacks made one after another in a frame share a pending entry, grown to cover them all, so many small ones
+	// do not fill the table.
+	if (PendingCount > 0)
+	{
+		ReadbackTicket& newest = Pending[(PendingStart + PendingCount - 1) % MaxPendingReadbacks];
+		if (newest.FenceValue == fenceValue && offset >= newest.Offset + newest.Size)
+		{
+			newest.Size = offset + size - newest.Offset;
+			Head = offset + size;
+			return ticket;
+		}
+	}
+
+	// With the table still full, the oldest entry is from an earlier frame, so waiting for it cannot stall on this one.
+	if (PendingCount == MaxPendingReadbacks)
+	{
+		const ReadbackTicket& oldest = Pending[PendingStart];
+		VERIFY(oldest.FenceValue < fenceValue, "Too many readbacks are pending for the readback ring to track!");
+		Wait(oldest);
+
+		PendingStart = (PendingStart + 1) % MaxPendingReadbacks;
+		--PendingCount;
+	}
+
+	Pending[(PendingStart + PendingCount) % MaxPendingReadbacks] = ticket;
+	++PendingCount;
+
+	Head = offset + size;
+	return ticket;
+}
+
+bool ReadbackRing::IsReady(const ReadbackTicket& ticket) const
+{
+	return Device->FrameFence->GetCompletedValue() >= ticket.FenceValue;
+}
+
+void ReadbackRing::Wait(const ReadbackTicket& ticket) const
+{
+	Device->FrameFence->WaitFor(ticket.FenceValue, InfiniteTimeout);
+}
+
+const void* ReadbackRing::GetData(const ReadbackTicket& ticket) const
+{
+	CHECK(IsReady(ticket));
+	return Mapped + ticket.Offset;
+}
+
+void ReadbackRing::Read(const ReadbackTicket& ticket, void* data) const
+{
+	const uint8* source = static_cast<const uint8*>(GetData(ticket));
+	for (usize row = 0; row < ticket.RowCount; ++row)
+	{
+		Platform::MemoryCopy(static_cast<uint8*>(data) + row * ticket.RowSize, source + row * ticket.RowPitch, ticket.RowSize);
+	}
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/ReadbackRing.hpp"
+
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+inline constexpr usize MaxPendingReadbacks = 256;
+
+class ReadbackRing final : public ReadbackRingDescription, NoCopy
+{
+public:
+	ReadbackRing(const ReadbackRingDescription& description, Device* device);
+	~ReadbackRing();
+
+	ReadbackTicket Allocate(usize size, usize alignment);
+
+	bool IsReady(const ReadbackTicket& ticket) const;
+	void Wait(const ReadbackTicket& ticket) const;
+
+	const void* GetData(const ReadbackTicket& ticket) const;
+	void Read(const ReadbackTicket& ticket, void* data) const;
+
+	Resource* Buffer;
+	uint8* Mapped;
+
+	usize Head;
+
+	ReadbackTicket Pending[MaxPendingReadbacks];
+	usize PendingStart;
+	usize PendingCount;
+
+	Device* Device;
+};
+
+}
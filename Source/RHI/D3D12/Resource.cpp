@@ -204,6 +204,44 @@ void Resource::WriteAccelerationStructureInstances(const ResourceDescription& fo
 	Native->Unmap(0, WriteEverything);
 }
 
+void Resource::Write(usize offset, usize size, const void* data)
+{
+	CHECK(data);
+	CHECK(HasFlags(Flags, ResourceFlags::Upload));
+	CHECK(Type == ResourceType::Buffer);
+	CHECK(offset + size <= Size);
+
+	const D3D12_RANGE writeRange =
+	{
+		.Begin = offset,
+		.End = offset + size,
+	};
+
+	void* mapped = nullptr;
+	CHECK_RESULT(Native->Map(0, &ReadNothing, &mapped));
+	Platform::MemoryCopy(static_cast<uint8*>(mapped) + offset, data, size);
+	Native->Unmap(0, &writeRange);
+}
+
+void Resource::Read(usize offset, usize size, void* data) const
+{
+	CHECK(data);
+	CHECK(HasFlags(Flags, ResourceFlags::ReadBack));
+	CHECK(Type == ResourceType::Buffer);
+	CHECK(offset + size <= Size);
+
+	const D3D12_RANGE readRange =
+	{
+		.Begin = offset,
+		.End = offset + size,
+	};
+
+	void* mapped = nullptr;
+	CHECK_RESULT(Native->Map(0, &readRange, &mapped));
+	Platform::MemoryCopy(data, static_cast<const uint8*>(mapped) + offset, size);
+	Native->Unmap(0, &WriteNothing);
+}
+
 void Resource::Copy(ID3D12GraphicsCommandList10* commandList, ID3D12Resource2* source) const
 {
 	switch (Type)
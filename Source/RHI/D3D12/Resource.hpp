@@ -17,6 +17,9 @@ public:
 	void WriteBuffer(const ResourceDescription& format, const void* data);
 	void WriteTexture(const ResourceDescription& format, const void* data);
 	void WriteAccelerationStructureInstances(const ResourceDescription& format, const void* data);
+	void Write(usize offset, usize size, const void* data);
+
+	void Read(usize offset, usize size, void* data) const;
 
 	void Copy(ID3D12GraphicsCommandList10* commandList, ID3D12Resource2* source) const;
 	void CopyBuffer(ID3D12GraphicsCommandList10* commandList, ID3D12Resource2* source) const;
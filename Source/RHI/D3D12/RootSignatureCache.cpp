@@ -0,0 +1,108 @@
+#include "RootSignatureCache.hpp"
+#include "Device.hpp"
+
+#include "RHI/Allocator.hpp"
+
+#include "Luft/Hash.hpp"
+
+#include <cstring>
+
+namespace RHI::D3D12
+{
+
+static constexpr usize RootSignatureBucketCount = 32;
+
+static bool Matches(const CachedRootSignature& cached, ID3DBlob* serialized)
+{
+	const usize size = serialized->GetBufferSize();
+	return cached.Serialized->GetBufferSize() == size &&
+		   memcmp(cached.Serialized->GetBufferPointer(), serialized->GetBufferPointer(), size) == 0;
+}
+
+RootSignatureCache::RootSignatureCache(D3D12::Device* device)
+	: Lock(SRWLOCK_INIT)
+	, RootSignatures(RootSignatureBucketCount, Allocator)
+	, Device(device)
+{
+}
+
+RootSignatureCache::~RootSignatureCache()
+{
+	for (auto& [_, cached] : RootSignatures)
+	{
+		SAFE_RELEASE(cached.Native);
+		SAFE_RELEASE(cached.Serialized);
+	}
+}
+
+void RootSignatureCache::Create(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& description, ID3D12RootSignature** rootSignature)
+{
+	// The description points at parameter arrays, so the serialized form is what gets compared.
+	ID3DBlob* serialized = nullptr;
+	ID3DBlob* errorBlob = nullptr;
+	const HRESULT serializeResult = D3D12SerializeVersionedRootSignature(&description, &serialized, &errorBlob);
+#if DEBUG
+	if (FAILED(serializeResult) && errorBlob)
+	{
+		char errorMessage[512] = {};
+		Platform::StringPrint("Root Signature Error: %s\n", errorMessage, sizeof(errorMessage), errorBlob->GetBufferPointer());
+		Platform::FatalError(errorMessage);
+	}
+#else
+	(void)serializeResult;
+#endif
+	SAFE_RELEASE(errorBlob);
+	CHECK(serialized);
+
+	const uint64 hash = HashFnv1a(serialized->GetBufferPointer(), serialized->GetBufferSize());
+
+	AcquireSRWLockShared(&Lock);
+	ID3D12RootSignature* existing = nullptr;
+	if (RootSignatures.Contains(hash) && Matches(RootSignatures[hash], serialized))
+	{
+		existing = RootSignatures[hash].Native;
+		existing->AddRef();
+	}
+	ReleaseSRWLockShared(&Lock);
+
+	if (existing)
+	{
+		SAFE_RELEASE(serialized);
+		*rootSignature = existing;
+		return;
+	}
+
+	AcquireSRWLockExclusive(&Lock);
+
+	// Another pipeline may have created the same root signature while the lock was released.
+	if (RootSignatures.Contains(hash))
+	{
+		const CachedRootSignature& cached = RootSignatures[hash];
+		if (Matches(cached, serialized))
+		{
+			cached.Native->AddRef();
+			*rootSignature = cached.Native;
+			ReleaseSRWLockExclusive(&Lock);
+			SAFE_RELEASE(serialized);
+			return;
+		}
+	}
+
+	CHECK_RESULT(Device->Native->CreateRootSignature(0,
+													 serialized->GetBufferPointer(),
+													 serialized->GetBufferSize(),
+													 IID_PPV_ARGS(rootSignature)));
+
+	// A hash collision with a different layout just goes uncached.
+	if (!RootSignatures.Contains(hash))
+	{
+		(*rootSignature)->AddRef();
+		RootSignatures.Add(hash, CachedRootSignature { *rootSignature, serialized });
+		serialized = nullptr;
+	}
+	ReleaseSRWLockExclusive(&Lock);
+
+	SAFE_RELEASE(serialized);
+}
+
+}
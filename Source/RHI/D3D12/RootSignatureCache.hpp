@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Forward.hpp"
+
+#include "Luft/HashTable.hpp"
+#include "Luft/NoCopy.hpp"
+
+namespace RHI::D3D12
+{
+
+struct CachedRootSignature
+{
+	ID3D12RootSignature* Native;
+	ID3DBlob* Serialized;
+};
+
+// Most pipelines reflect the same handful of root parameters, so root signatures are shared between every pipeline
+// whose serialized description matches. Each pipeline holds its own COM reference, and the cache holds one more until
+// the device is destroyed.
+class RootSignatureCache final : public NoCopy
+{
+public:
+	explicit RootSignatureCache(Device* device);
+	~RootSignatureCache();
+
+	void Create(const D3D12_VERSIONED_ROOT_SIGNATURE_DESC& description, ID3D12RootSignature** rootSignature);
+
+	SRWLOCK Lock;
+	HashTable<uint64, CachedRootSignature> RootSignatures;
+
+	Device* Device;
+};
+
+}
@@ -2,6 +2,8 @@
 #include "Base.hpp"
 #include "Convert.hpp"
 #include "Device.hpp"
+#include "ShaderArchive.hpp"
+#include "ShaderCache.hpp"
 
 #include "D3D12/d3d12shader.h"
 #include "dxc/dxcapi.h"
@@ -23,131 +25,235 @@ namespace DXC
 static IDxcCompiler3* Compiler = nullptr;
 static IDxcUtils* Utils = nullptr;
 
-void Init()
+void Init(StringView cachePath, usize cacheSize, StringView archivePath)
 {
-	constexpr IMalloc* dxcAllocator = nullptr;
-	HRESULT result = DxcCreateInstance2(dxcAllocator, CLSID_DxcCompiler, IID_PPV_ARGS(&Compiler));
-	CHECK(SUCCEEDED(result));
-	result = DxcCreateInstance2(dxcAllocator, CLSID_DxcUtils, IID_PPV_ARGS(&Utils));
-	CHECK(SUCCEEDED(result));
+	CreateCompiler(&Compiler, &Utils);
+
+	wchar_t cacheDirectory[MAX_PATH] = {};
+	ToWideChar(cachePath, cacheDirectory, ARRAY_COUNT(cacheDirectory) - 1);
+	InitCache(cacheDirectory, cacheSize, Compiler);
+
+	wchar_t archiveFile[MAX_PATH] = {};
+	ToWideChar(archivePath, archiveFile, ARRAY_COUNT(archiveFile) - 1);
+	OpenArchive(archiveFile);
 }
 
 void Shutdown()
 {
+	CloseArchive();
+	ShutdownCache();
+
 	SAFE_RELEASE(Utils);
 	SAFE_RELEASE(Compiler);
 }
 
-void ReflectInputElements(ID3D12ShaderReflection* shaderReflection, Array<D3D12_INPUT_ELEMENT_DESC>& inputElements)
+static const RHI::VertexAttribute* FindVertexAttribute(ArrayView<const RHI::VertexAttribute> attributes,
+													  const RHI::ReflectedInputElement& inputElement)
 {
-	D3D12_SHADER_DESC shaderDescription = {};
-	CHECK_RESULT(shaderReflection->GetDesc(&shaderDescription));
-
-	for (uint32 i = 0; i < shaderDescription.InputParameters; ++i)
+	const StringView semanticName(inputElement.SemanticName, Platform::StringLength(inputElement.SemanticName));
+	for (const RHI::VertexAttribute& attribute : attributes)
 	{
-		D3D12_SIGNATURE_PARAMETER_DESC inputParameterDescription = {};
-		CHECK_RESULT(shaderReflection->GetInputParameterDesc(i, &inputParameterDescription));
-
-		const bool systemValue = inputParameterDescription.SystemValueType != D3D_NAME_UNDEFINED;
-		if (systemValue)
+		if (attribute.Semantic == semanticName && attribute.SemanticIndex == inputElement.SemanticIndex)
 		{
-			continue;
+			return &attribute;
 		}
+	}
+	return nullptr;
+}
+
+void ReflectInputElements(const RHI::ShaderReflection& reflection,
+						  ArrayView<const RHI::VertexAttribute> attributes,
+						  Array<D3D12_INPUT_ELEMENT_DESC>& inputElements)
+{
+	usize overrideCount = 0;
+	for (uint32 i = 0; i < reflection.InputElementCount; ++i)
+	{
+		const RHI::ReflectedInputElement& inputElement = reflection.InputElements[i];
+
+		const RHI::VertexAttribute* attribute = FindVertexAttribute(attributes, inputElement);
+		const bool overridden = attribute && attribute->Format != RHI::VertexFormat::Inferred;
+		overrideCount += attribute ? 1 : 0;
+		const bool placed = attribute && attribute->Placed;
+		const bool appended = !placed || attribute->Offset == RHI::VertexOffsetAppend;
+		VERIFY(!placed || attribute->Stream < D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT,
+			   "A vertex attribute names a stream beyond the last vertex buffer slot!");
 
 		inputElements.Add(D3D12_INPUT_ELEMENT_DESC
 		{
-			.SemanticName = inputParameterDescription.SemanticName,
-			.SemanticIndex = inputParameterDescription.SemanticIndex,
-			.Format = RHI::D3D12::MaskToFormat(inputParameterDescription.Mask),
-			.InputSlot = inputParameterDescription.Register,
-			.AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT,
+			.SemanticName = inputElement.SemanticName,
+			.SemanticIndex = inputElement.SemanticIndex,
+			.Format = overridden ? RHI::D3D12::To(attribute->Format) : RHI::D3D12::To(inputElement),
+			.InputSlot = placed ? attribute->Stream : inputElement.Slot,
+			.AlignedByteOffset = appended ? D3D12_APPEND_ALIGNED_ELEMENT : attribute->Offset,
 			.InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
 			.InstanceDataStepRate = 0,
 		});
 	}
+
+	VERIFY(overrideCount == attributes.GetLength(), "A vertex attribute names an input the vertex shader does not have!");
 }
 
-void ReflectRootParameters(ID3D12ShaderReflection* shaderReflection,
-						   HashTable<String, RootParameter>* rootParameters,
-						   HashTable<String, D3D12_ROOT_PARAMETER1>* apiRootParameters)
+static D3D12_ROOT_PARAMETER1 ToRootDescriptor(D3D12_ROOT_PARAMETER_TYPE type,
+											   const RHI::ReflectedBinding& binding,
+											   D3D12_ROOT_DESCRIPTOR_FLAGS flags)
 {
-	D3D12_SHADER_DESC shaderDescription = {};
-	CHECK_RESULT(shaderReflection->GetDesc(&shaderDescription));
-
-	for (uint32 i = 0; i < shaderDescription.BoundResources; ++i)
+	return D3D12_ROOT_PARAMETER1
 	{
-		D3D12_SHADER_INPUT_BIND_DESC resourceDescription = {};
-		CHECK_RESULT(shaderReflection->GetResourceBindingDesc(i, &resourceDescription));
+		.ParameterType = type,
+		.Descriptor =
+		{
+			.ShaderRegister = binding.Register,
+			.RegisterSpace = binding.Space,
+			.Flags = flags,
+		},
+		.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL,
+	};
+}
 
-		CHECK(resourceDescription.Type == D3D_SIT_CBUFFER);
+void ReflectRootParameters(const RHI::ShaderReflection& reflection,
+						   HashTable<String, RootParameter>* rootParameters,
+						   HashTable<String, D3D12_ROOT_PARAMETER1>* apiRootParameters,
+						   Array<D3D12_STATIC_SAMPLER_DESC>* staticSamplers)
+{
+	for (uint32 i = 0; i < reflection.BindingCount; ++i)
+	{
+		const RHI::ReflectedBinding& binding = reflection.Bindings[i];
 
-		const usize resourceNameLength = Platform::StringLength(resourceDescription.Name);
-		String resourceName(resourceNameLength, RHI::Allocator);
-		for (usize j = 0; j < resourceNameLength; ++j)
+		// Shaders of one pipeline may both declare the same sampler.
+		if (binding.Type == RHI::ReflectedBindingType::StaticSampler)
 		{
-			resourceName.Append(resourceDescription.Name[j]);
+			bool declared = false;
+			for (const D3D12_STATIC_SAMPLER_DESC& staticSampler : *staticSamplers)
+			{
+				declared = declared || staticSampler.ShaderRegister == binding.Register;
+			}
+			if (!declared)
+			{
+				staticSamplers->Add(RHI::D3D12::To(static_cast<RHI::StaticSampler>(binding.Register)));
+			}
+			continue;
 		}
 
-		D3D12_SHADER_VARIABLE_DESC variableDescription = {};
-		ID3D12ShaderReflectionVariable* variable = shaderReflection->GetVariableByName(resourceDescription.Name);
-		CHECK_RESULT(variable->GetDesc(&variableDescription));
+		const usize bindingNameLength = Platform::StringLength(binding.Name);
+		String bindingName(bindingNameLength, RHI::Allocator);
+		for (usize j = 0; j < bindingNameLength; ++j)
+		{
+			bindingName.Append(binding.Name[j]);
+		}
+		if (rootParameters->Contains(bindingName))
+		{
+			continue;
+		}
 
-		rootParameters->Add(resourceName, RootParameter
+		rootParameters->Add(bindingName, RootParameter
 		{
-			.Index = i,
-			.Size = variableDescription.Size,
+			.Index = apiRootParameters->GetCount(),
+			.Size = binding.Size,
+			.Type = binding.Type,
 		});
 
-		static constexpr char rootConstantsName[] = "RootConstants";
-		const bool rootConstant = Platform::StringCompare(resourceDescription.Name,
-														  Platform::StringLength(resourceDescription.Name),
-														  rootConstantsName,
-														  sizeof(rootConstantsName));
-
-		if (rootConstant)
+		if (binding.Type == RHI::ReflectedBindingType::RootConstants)
 		{
-			apiRootParameters->Add(Move(resourceName),
+			apiRootParameters->Add(Move(bindingName),
 								   D3D12_ROOT_PARAMETER1
 								   {
 									   .ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
 									   .Constants =
 									   {
-										   .ShaderRegister = resourceDescription.BindPoint,
-										   .RegisterSpace = resourceDescription.Space,
-										   .Num32BitValues = static_cast<uint32>(variableDescription.Size / sizeof(uint32)),
+										   .ShaderRegister = binding.Register,
+										   .RegisterSpace = binding.Space,
+										   .Num32BitValues = static_cast<uint32>(binding.Size / sizeof(uint32)),
 									   },
 									   .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL,
 								   });
 		}
+		else if (binding.Type == RHI::ReflectedBindingType::ShaderResource)
+		{
+			apiRootParameters->Add(Move(bindingName),
+								   ToRootDescriptor(D3D12_ROOT_PARAMETER_TYPE_SRV,
+													binding,
+													D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE));
+		}
+		else if (binding.Type == RHI::ReflectedBindingType::UnorderedAccess)
+		{
+			apiRootParameters->Add(Move(bindingName),
+								   ToRootDescriptor(D3D12_ROOT_PARAMETER_TYPE_UAV, binding, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_VOLATILE));
+		}
 		else
 		{
-			apiRootParameters->Add(Move(resourceName),
-								   D3D12_ROOT_PARAMETER1
-								   {
-									   .ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV,
-									   .Descriptor =
-									   {
-										   .ShaderRegister = resourceDescription.BindPoint,
-										   .RegisterSpace = resourceDescription.Space,
-										   .Flags = D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE,
-									   },
-									   .ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL,
-								   });
+			apiRootParameters->Add(Move(bindingName),
+								   ToRootDescriptor(D3D12_ROOT_PARAMETER_TYPE_CBV,
+													binding,
+													D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC_WHILE_SET_AT_EXECUTE));
 		}
 	}
 }
 
-static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, ArrayView<const RHI::ShaderDefine> defines)
+static void AppendError(String* error, const char* message, usize messageLength)
 {
-	CHECK(Compiler && Utils);
+	for (usize i = 0; i < messageLength && message[i] != '\0'; ++i)
+	{
+		error->Append(message[i]);
+	}
+}
+
+static bool DistillReflectionBlob(IDxcUtils* utils, IDxcBlob* reflectionBlob, RHI::ShaderReflection* reflection, String* error)
+{
+	const DxcBuffer reflectionBuffer =
+	{
+		.Ptr = reflectionBlob->GetBufferPointer(),
+		.Size = reflectionBlob->GetBufferSize(),
+		.Encoding = 0,
+	};
+
+	ID3D12ShaderReflection* shaderReflection = nullptr;
+	CHECK_RESULT(utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&shaderReflection)));
+	const bool distilled = DistillReflection(shaderReflection, reflection);
+	SAFE_RELEASE(shaderReflection);
+
+	if (!distilled)
+	{
+		static constexpr char reflectionError[] = "Shader bindings do not fit in RHI::ShaderReflection!";
+		AppendError(error, reflectionError, sizeof(reflectionError));
+	}
+	return distilled;
+}
+
+void CreateCompiler(IDxcCompiler3** compiler, IDxcUtils** utils)
+{
+	constexpr IMalloc* dxcAllocator = nullptr;
+	CHECK_RESULT(DxcCreateInstance2(dxcAllocator, CLSID_DxcCompiler, IID_PPV_ARGS(compiler)));
+	CHECK_RESULT(DxcCreateInstance2(dxcAllocator, CLSID_DxcUtils, IID_PPV_ARGS(utils)));
+}
+
+bool CompileShader(IDxcCompiler3* compiler, IDxcUtils* utils, const RHI::ShaderDescription& description, CompileOutput* output, String* error)
+{
+	output->Blob = nullptr;
+	output->Reflection = {};
+
+	ArchivedShader archivedShader = {};
+	if (FindArchivedShader(description, &archivedShader))
+	{
+		IDxcBlobEncoding* pinnedBlob = nullptr;
+		CHECK_RESULT(utils->CreateBlobFromPinned(archivedShader.Blob, static_cast<uint32>(archivedShader.BlobSize), DXC_CP_ACP, &pinnedBlob));
+		output->Blob = pinnedBlob;
+
+		Platform::MemoryCopy(&output->Reflection, archivedShader.Reflection, sizeof(output->Reflection));
+		return true;
+	}
 
 	wchar_t pathBuffer[MAX_PATH] = {};
-	ToWideChar(filePath, pathBuffer, ARRAY_COUNT(pathBuffer));
+	ToWideChar(description.FilePath, pathBuffer, ARRAY_COUNT(pathBuffer));
 
 	uint32 codePage = DXC_CP_UTF8;
 	IDxcBlobEncoding* sourceBlob = nullptr;
-	HRESULT dxcResult = Utils->LoadFile(pathBuffer, &codePage, &sourceBlob);
-	VERIFY(SUCCEEDED(dxcResult), "Failed to read shader from file system!");
+	HRESULT dxcResult = utils->LoadFile(pathBuffer, &codePage, &sourceBlob);
+	if (FAILED(dxcResult))
+	{
+		static constexpr char fileError[] = "Failed to read shader from file system!";
+		AppendError(error, fileError, sizeof(fileError));
+		return false;
+	}
 
 	const wchar_t* arguments[] =
 	{
@@ -173,7 +279,7 @@ static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, Ar
 
 	LPCWSTR entryPoint = nullptr;
 	LPCWSTR profile = nullptr;
-	switch (stage)
+	switch (description.Stage)
 	{
 	case RHI::ShaderStage::Vertex:
 		entryPoint = L"VertexStart";
@@ -191,8 +297,8 @@ static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, Ar
 		CHECK(false);
 	}
 
-	Array<DxcDefine> dxcDefines(defines.GetLength(), RHI::Allocator);
-	for (const RHI::ShaderDefine& define : defines)
+	Array<DxcDefine> dxcDefines(description.Defines.GetLength(), RHI::Allocator);
+	for (const RHI::ShaderDefine& define : description.Defines)
 	{
 		wchar_t name[64] = {};
 		ToWideChar(define.Name, name, ARRAY_COUNT(name));
@@ -208,7 +314,7 @@ static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, Ar
 	}
 
 	IDxcCompilerArgs* compileArguments = nullptr;
-	CHECK_RESULT(Utils->BuildArguments(pathBuffer,
+	CHECK_RESULT(utils->BuildArguments(pathBuffer,
 									   entryPoint,
 									   profile,
 									   arguments,
@@ -217,20 +323,31 @@ static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, Ar
 									   static_cast<uint32>(dxcDefines.GetLength()),
 									   &compileArguments));
 
-	IDxcIncludeHandler* includeHandler = nullptr;
-	CHECK_RESULT(Utils->CreateDefaultIncludeHandler(&includeHandler));
-
 	const DxcBuffer buffer =
 	{
 		.Ptr = static_cast<uint8*>(sourceBlob->GetBufferPointer()),
 		.Size = sourceBlob->GetBufferSize(),
 		.Encoding = DXC_CP_UTF8,
 	};
+
+	const CacheKey cacheKey = HashCompile(compileArguments, buffer);
+	if (LoadCache(cacheKey, utils, &output->Blob, &output->Reflection, &output->Dependencies))
+	{
+		SAFE_RELEASE(compileArguments);
+		SAFE_RELEASE(sourceBlob);
+		return true;
+	}
+
+	IDxcIncludeHandler* includeHandler = nullptr;
+	CHECK_RESULT(utils->CreateDefaultIncludeHandler(&includeHandler));
+
+	IncludeRecorder includeRecorder(includeHandler, &output->Dependencies);
+
 	IDxcResult* compileResult = nullptr;
-	dxcResult = Compiler->Compile(&buffer,
+	dxcResult = compiler->Compile(&buffer,
 								  compileArguments->GetArguments(),
 								  compileArguments->GetCount(),
-								  includeHandler,
+								  &includeRecorder,
 								  IID_PPV_ARGS(&compileResult));
 	CHECK(SUCCEEDED(dxcResult) && compileResult);
 
@@ -240,18 +357,105 @@ static IDxcResult* CompileShader(StringView filePath, RHI::ShaderStage stage, Ar
 
 	const HRESULT statusResult = compileResult->GetStatus(&dxcResult);
 	CHECK(SUCCEEDED(statusResult));
-#if DEBUG
 	if (FAILED(dxcResult))
 	{
 		IDxcBlobEncoding* errorBlob = nullptr;
-		dxcResult = compileResult->GetErrorBuffer(&errorBlob);
-		CHECK(SUCCEEDED(dxcResult) && errorBlob);
-		char errorMessage[2048];
-		Platform::StringPrint("Shader Compiler: %s", errorMessage, sizeof(errorMessage), errorBlob->GetBufferPointer());
-		Platform::FatalError(errorMessage);
+		CHECK_RESULT(compileResult->GetErrorBuffer(&errorBlob));
+		if (errorBlob)
+		{
+			AppendError(error, static_cast<const char*>(errorBlob->GetBufferPointer()), errorBlob->GetBufferSize());
+		}
+		SAFE_RELEASE(errorBlob);
+		SAFE_RELEASE(compileResult);
+		return false;
+	}
+
+	IDxcBlob* reflectionBlob = nullptr;
+	CHECK_RESULT(compileResult->GetResult(&output->Blob));
+	CHECK_RESULT(compileResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr));
+	SAFE_RELEASE(compileResult);
+
+	const bool distilled = DistillReflectionBlob(utils, reflectionBlob, &output->Reflection, error);
+	SAFE_RELEASE(reflectionBlob);
+	if (!distilled)
+	{
+		SAFE_RELEASE(output->Blob);
+		return false;
+	}
+
+	StoreCache(cacheKey, output->Dependencies, output->Blob, output->Reflection);
+	return true;
+}
+
+struct CompileJob
+{
+	ArrayView<const RHI::ShaderDescription> Descriptions;
+	CompileOutput* Outputs;
+	String* Errors;
+	volatile LONG64 NextIndex;
+};
+
+static void RunCompileJob(CompileJob* job, IDxcCompiler3* compiler, IDxcUtils* utils)
+{
+	while (true)
+	{
+		const usize index = static_cast<usize>(InterlockedIncrement64(&job->NextIndex) - 1);
+		if (index >= job->Descriptions.GetLength())
+		{
+			break;
+		}
+
+		CompileShader(compiler, utils, job->Descriptions[index], &job->Outputs[index], &job->Errors[index]);
+	}
+}
+
+static DWORD WINAPI CompileThread(void* parameter)
+{
+	IDxcCompiler3* compiler = nullptr;
+	IDxcUtils* utils = nullptr;
+	CreateCompiler(&compiler, &utils);
+
+	RunCompileJob(static_cast<CompileJob*>(parameter), compiler, utils);
+
+	SAFE_RELEASE(utils);
+	SAFE_RELEASE(compiler);
+	return 0;
+}
+
+void CompileBatch(ArrayView<const RHI::ShaderDescription> descriptions, CompileOutput* outputs, String* errors)
+{
+	CHECK(Compiler && Utils);
+
+	CompileJob job =
+	{
+		.Descriptions = descriptions,
+		.Outputs = outputs,
+		.Errors = errors,
+		.NextIndex = 0,
+	};
+
+	usize threadCount = GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+	threadCount = threadCount < MaxCompileThreads ? threadCount : MaxCompileThreads;
+	threadCount = threadCount < descriptions.GetLength() ? threadCount : descriptions.GetLength();
+
+	HANDLE threads[MaxCompileThreads] = {};
+	const usize workerCount = threadCount > 0 ? threadCount - 1 : 0;
+	for (usize i = 0; i < workerCount; ++i)
+	{
+		threads[i] = CreateThread(nullptr, 0, CompileThread, &job, 0, nullptr);
+		CHECK(threads[i]);
+	}
+
+	RunCompileJob(&job, Compiler, Utils);
+
+	if (workerCount > 0)
+	{
+		WaitForMultipleObjects(static_cast<DWORD>(workerCount), threads, TRUE, INFINITE);
+	}
+	for (usize i = 0; i < workerCount; ++i)
+	{
+		CloseHandle(threads[i]);
 	}
-#endif
-	return compileResult;
 }
 
 }
@@ -261,31 +465,97 @@ namespace RHI::D3D12
 
 Shader::Shader(const ShaderDescription& description, D3D12::Device* device)
 	: ShaderDescription(description)
+	, Blob(nullptr)
+	, Reflection()
+	, Dependencies(RHI::Allocator)
 	, Device(device)
+#if !RELEASE
+	, HotReloadPrevious(nullptr)
+	, HotReloadNext(nullptr)
+	, PendingReload(nullptr)
+	, Reloaded(false)
+#endif
+	, OwnedDefines(description.Defines.GetLength(), RHI::Allocator)
+	, OwnedStrings(RHI::Allocator)
 {
-	IDxcResult* compileResult = DXC::CompileShader(FilePath, Stage, Defines);
+	OwnDescription();
 
-	CHECK_RESULT(compileResult->GetResult(&Blob));
+	DXC::CompileOutput output =
+	{
+		.Blob = nullptr,
+		.Reflection = {},
+		.Dependencies = Array<DXC::CacheDependency>(RHI::Allocator),
+	};
 
-	IDxcBlob* reflectionBlob = {};
-	CHECK_RESULT(compileResult->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr));
+	String error(0, RHI::Allocator);
+	if (!DXC::CompileShader(DXC::Compiler, DXC::Utils, description, &output, &error))
+	{
+		char errorMessage[2048];
+		Platform::StringPrint("Shader Compiler: %.*s",
+							  errorMessage,
+							  sizeof(errorMessage),
+							  static_cast<int32>(error.GetLength()),
+							  error.GetData());
+		Platform::FatalError(errorMessage);
+	}
 
-	const DxcBuffer reflectionBuffer =
+	Blob = output.Blob;
+	Reflection = output.Reflection;
+	Dependencies = Move(output.Dependencies);
+}
+
+void Shader::OwnDescription()
+{
+	// Sized up front so the views taken into it below are not moved by a later growth.
+	usize stringsLength = FilePath.GetLength();
+	for (const ShaderDefine& define : Defines)
 	{
-		.Ptr = reflectionBlob->GetBufferPointer(),
-		.Size = reflectionBlob->GetBufferSize(),
-		.Encoding = 0,
+		stringsLength += define.Name.GetLength() + define.Value.GetLength();
+	}
+	OwnedStrings.GrowToLengthUninitialized(stringsLength);
+
+	usize stringsOffset = 0;
+	const auto ownString = [&](StringView string) -> StringView
+	{
+		char* owned = OwnedStrings.GetData() + stringsOffset;
+		Platform::MemoryCopy(owned, string.GetData(), string.GetLength());
+		stringsOffset += string.GetLength();
+		return StringView(owned, string.GetLength());
 	};
-	CHECK_RESULT(DXC::Utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&Reflection)));
 
-	SAFE_RELEASE(reflectionBlob);
-	SAFE_RELEASE(compileResult);
+	FilePath = ownString(FilePath);
+	for (const ShaderDefine& define : Defines)
+	{
+		OwnedDefines.Add(ShaderDefine
+		{
+			.Name = ownString(define.Name),
+			.Value = ownString(define.Value),
+		});
+	}
+	Defines = ArrayView<const ShaderDefine>(OwnedDefines.GetData(), OwnedDefines.GetLength());
+}
+
+Shader::Shader(const ShaderDescription& description, D3D12::Device* device, DXC::CompileOutput* output)
+	: ShaderDescription(description)
+	, Blob(output->Blob)
+	, Reflection(output->Reflection)
+	, Dependencies(Move(output->Dependencies))
+	, Device(device)
+#if !RELEASE
+	, HotReloadPrevious(nullptr)
+	, HotReloadNext(nullptr)
+	, PendingReload(nullptr)
+	, Reloaded(false)
+#endif
+	, OwnedDefines(description.Defines.GetLength(), RHI::Allocator)
+	, OwnedStrings(RHI::Allocator)
+{
+	OwnDescription();
 }
 
 Shader::~Shader()
 {
 	SAFE_RELEASE(Blob);
-	SAFE_RELEASE(Reflection);
 }
 
 }
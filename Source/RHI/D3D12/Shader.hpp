@@ -2,9 +2,25 @@
 
 #include "Base.hpp"
 
+#include "ShaderCache.hpp"
+#include "ShaderReflection.hpp"
+
 #include "RHI/Shader.hpp"
 
 #include "Luft/HashTable.hpp"
+#include "Luft/String.hpp"
+
+namespace DXC
+{
+
+struct CompileOutput
+{
+	IDxcBlob* Blob;
+	RHI::ShaderReflection Reflection;
+	Array<CacheDependency> Dependencies;
+};
+
+}
 
 namespace RHI::D3D12
 {
@@ -13,11 +29,29 @@ class Shader final : public ShaderDescription, NoCopy
 {
 public:
 	Shader(const ShaderDescription& description, Device* device);
+	Shader(const ShaderDescription& description, Device* device, DXC::CompileOutput* output);
 	~Shader();
 
+	// Only needed until every pipeline using the shader is created, see Device::ReleaseBytecode.
 	IDxcBlob* Blob;
-	ID3D12ShaderReflection* Reflection;
+	RHI::ShaderReflection Reflection;
+	Array<DXC::CacheDependency> Dependencies;
 	Device* Device;
+
+#if !RELEASE
+	Shader* HotReloadPrevious;
+	Shader* HotReloadNext;
+	DXC::CompileOutput* PendingReload;
+	bool Reloaded;
+#endif
+
+private:
+	void OwnDescription();
+
+	// Hot reload recompiles from the description long after Create returns, so the path and defines are copied here
+	// and the description's views point into these instead.
+	Array<ShaderDefine> OwnedDefines;
+	Array<char> OwnedStrings;
 };
 
 }
@@ -25,18 +59,28 @@ public:
 namespace DXC
 {
 
+inline constexpr usize MaxCompileThreads = MAXIMUM_WAIT_OBJECTS;
+
 struct RootParameter
 {
 	usize Index;
 	usize Size;
+	RHI::ReflectedBindingType Type;
 };
 
-void Init();
+void Init(StringView cachePath, usize cacheSize, StringView archivePath);
 void Shutdown();
 
-void ReflectInputElements(ID3D12ShaderReflection* shaderReflection, Array<D3D12_INPUT_ELEMENT_DESC>& inputElements);
-void ReflectRootParameters(ID3D12ShaderReflection* shaderReflection,
+void CreateCompiler(IDxcCompiler3** compiler, IDxcUtils** utils);
+bool CompileShader(IDxcCompiler3* compiler, IDxcUtils* utils, const RHI::ShaderDescription& description, CompileOutput* output, String* error);
+void CompileBatch(ArrayView<const RHI::ShaderDescription> descriptions, CompileOutput* outputs, String* errors);
+
+void ReflectInputElements(const RHI::ShaderReflection& reflection,
+						  ArrayView<const RHI::VertexAttribute> attributes,
+						  Array<D3D12_INPUT_ELEMENT_DESC>& inputElements);
+void ReflectRootParameters(const RHI::ShaderReflection& reflection,
 						   HashTable<String, RootParameter>* rootParameters,
-						   HashTable<String, D3D12_ROOT_PARAMETER1>* apiRootParameters);
+						   HashTable<String, D3D12_ROOT_PARAMETER1>* apiRootParameters,
+						   Array<D3D12_STATIC_SAMPLER_DESC>* staticSamplers);
 
 }
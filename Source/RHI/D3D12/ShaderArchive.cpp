@@ -0,0 +1,196 @@
+#include "ShaderArchive.hpp"
+
+#include "RHI/ShaderArchive.hpp"
+#include "RHI/ShaderReflection.hpp"
+
+namespace DXC
+{
+
+static HANDLE ArchiveFile = INVALID_HANDLE_VALUE;
+static HANDLE ArchiveMapping = nullptr;
+static const uint8* ArchiveView = nullptr;
+static usize ArchiveSize = 0;
+
+static const RHI::ShaderArchiveEntry* ArchiveEntries = nullptr;
+static usize ArchiveEntryCount = 0;
+
+static double ArchiveLoadTime = 0.0;
+static volatile LONG64 ArchiveLookups = 0;
+static volatile LONG64 ArchiveHits = 0;
+static volatile LONG64 ArchiveLookupTicks = 0;
+
+static double GetPerformanceCounterFrequency()
+{
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	return static_cast<double>(frequency.QuadPart);
+}
+
+static bool IsValidArchive(const uint8* view, usize size)
+{
+	if (size < sizeof(RHI::ShaderArchiveHeader))
+	{
+		return false;
+	}
+
+	RHI::ShaderArchiveHeader header = {};
+	Platform::MemoryCopy(&header, view, sizeof(header));
+	if (header.Magic != RHI::ShaderArchiveMagic || header.Version != RHI::ShaderArchiveVersion)
+	{
+		return false;
+	}
+	if (header.EntryCount > (size - sizeof(header)) / sizeof(RHI::ShaderArchiveEntry))
+	{
+		return false;
+	}
+
+	const RHI::ShaderArchiveEntry* entries = reinterpret_cast<const RHI::ShaderArchiveEntry*>(view + sizeof(header));
+	for (usize i = 0; i < header.EntryCount; ++i)
+	{
+		const RHI::ShaderArchiveEntry& entry = entries[i];
+		const bool inBounds = entry.BlobOffset <= size && entry.BlobSize <= size - entry.BlobOffset &&
+							  entry.ReflectionOffset <= size && entry.ReflectionSize <= size - entry.ReflectionOffset &&
+							  entry.ReflectionSize == sizeof(RHI::ShaderReflection);
+		const bool sorted = i == 0 || entries[i - 1].Key < entry.Key;
+		if (!inBounds || !sorted)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void OpenArchive(const wchar_t* path)
+{
+	ArchiveLoadTime = 0.0;
+	ArchiveLookups = 0;
+	ArchiveHits = 0;
+	ArchiveLookupTicks = 0;
+
+	if (!path || path[0] == L'\0')
+	{
+		return;
+	}
+
+	LARGE_INTEGER loadStart;
+	QueryPerformanceCounter(&loadStart);
+
+	ArchiveFile = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+	VERIFY(ArchiveFile != INVALID_HANDLE_VALUE, "Failed to open the shader archive!");
+
+	LARGE_INTEGER fileSize = {};
+	const bool validSize = GetFileSizeEx(ArchiveFile, &fileSize) != 0;
+	CHECK(validSize);
+	ArchiveSize = static_cast<usize>(fileSize.QuadPart);
+
+	ArchiveMapping = CreateFileMappingW(ArchiveFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CHECK(ArchiveMapping);
+	ArchiveView = static_cast<const uint8*>(MapViewOfFile(ArchiveMapping, FILE_MAP_READ, 0, 0, 0));
+	CHECK(ArchiveView);
+
+	VERIFY(IsValidArchive(ArchiveView, ArchiveSize), "The shader archive is corrupt or was built by an incompatible ShaderArchiver!");
+
+	RHI::ShaderArchiveHeader header = {};
+	Platform::MemoryCopy(&header, ArchiveView, sizeof(header));
+	ArchiveEntries = reinterpret_cast<const RHI::ShaderArchiveEntry*>(ArchiveView + sizeof(header));
+	ArchiveEntryCount = header.EntryCount;
+
+	LARGE_INTEGER loadEnd;
+	QueryPerformanceCounter(&loadEnd);
+	ArchiveLoadTime = static_cast<double>(loadEnd.QuadPart - loadStart.QuadPart) / GetPerformanceCounterFrequency();
+}
+
+void CloseArchive()
+{
+	if (ArchiveView)
+	{
+		UnmapViewOfFile(ArchiveView);
+		ArchiveView = nullptr;
+	}
+	if (ArchiveMapping)
+	{
+		CloseHandle(ArchiveMapping);
+		ArchiveMapping = nullptr;
+	}
+	if (ArchiveFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(ArchiveFile);
+		ArchiveFile = INVALID_HANDLE_VALUE;
+	}
+	ArchiveEntries = nullptr;
+	ArchiveEntryCount = 0;
+	ArchiveSize = 0;
+}
+
+bool FindArchivedShader(const RHI::ShaderDescription& description, ArchivedShader* archivedShader)
+{
+	if (!ArchiveEntries)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER lookupStart;
+	QueryPerformanceCounter(&lookupStart);
+
+	uint64 defineHashSum = 0;
+	for (const RHI::ShaderDefine& define : description.Defines)
+	{
+		defineHashSum += RHI::HashShaderArchiveDefine(define.Name.GetData(),
+													  define.Name.GetLength(),
+													  define.Value.GetData(),
+													  define.Value.GetLength());
+	}
+	const uint64 key = RHI::HashShaderArchiveKey(description.FilePath.GetData(),
+												 description.FilePath.GetLength(),
+												 static_cast<uint8>(description.Stage),
+												 defineHashSum);
+
+	usize low = 0;
+	usize high = ArchiveEntryCount;
+	while (low < high)
+	{
+		const usize middle = low + (high - low) / 2;
+		if (ArchiveEntries[middle].Key < key)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+
+	const bool found = low < ArchiveEntryCount && ArchiveEntries[low].Key == key;
+	if (found)
+	{
+		const RHI::ShaderArchiveEntry& entry = ArchiveEntries[low];
+		archivedShader->Blob = ArchiveView + entry.BlobOffset;
+		archivedShader->BlobSize = entry.BlobSize;
+		archivedShader->Reflection = ArchiveView + entry.ReflectionOffset;
+		archivedShader->ReflectionSize = entry.ReflectionSize;
+	}
+
+	LARGE_INTEGER lookupEnd;
+	QueryPerformanceCounter(&lookupEnd);
+	InterlockedAdd64(&ArchiveLookupTicks, lookupEnd.QuadPart - lookupStart.QuadPart);
+	InterlockedIncrement64(&ArchiveLookups);
+	if (found)
+	{
+		InterlockedIncrement64(&ArchiveHits);
+	}
+	return found;
+}
+
+RHI::ShaderArchiveStatistics GetArchiveStatistics()
+{
+	return RHI::ShaderArchiveStatistics
+	{
+		.EntryCount = ArchiveEntryCount,
+		.LoadTime = ArchiveLoadTime,
+		.Lookups = static_cast<usize>(ArchiveLookups),
+		.Hits = static_cast<usize>(ArchiveHits),
+		.LookupTime = static_cast<double>(ArchiveLookupTicks) / GetPerformanceCounterFrequency(),
+	};
+}
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Shader.hpp"
+
+namespace DXC
+{
+
+struct ArchivedShader
+{
+	const void* Blob;
+	usize BlobSize;
+	const void* Reflection;
+	usize ReflectionSize;
+};
+
+void OpenArchive(const wchar_t* path);
+void CloseArchive();
+
+bool FindArchivedShader(const RHI::ShaderDescription& description, ArchivedShader* archivedShader);
+
+RHI::ShaderArchiveStatistics GetArchiveStatistics();
+
+}
@@ -0,0 +1,415 @@
+#include "ShaderCache.hpp"
+
+#include "RHI/Allocator.hpp"
+
+#include <bcrypt.h>
+#include <cwchar>
+
+#pragma comment(lib, "bcrypt")
+
+namespace DXC
+{
+
+static constexpr uint32 CacheMagic = 0x43535248;
+static constexpr uint32 CacheVersion = 4;
+
+static constexpr usize DefaultCacheSize = 256 * 1024 * 1024;
+
+struct CacheHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint32 DependencyCount;
+	uint32 Reserved;
+	uint64 BlobSize;
+	uint64 ReflectionSize;
+};
+
+struct CacheFile
+{
+	wchar_t Name[MAX_PATH];
+	uint64 Size;
+	uint64 LastAccess;
+};
+
+static wchar_t CacheDirectory[MAX_PATH] = {};
+static usize CacheMaximumSize = 0;
+static uint32 CompilerVersion[2] = {};
+
+static RHI::ShaderCacheStatistics CacheStatistics = {};
+
+static void AddStatistic(usize* statistic, usize value)
+{
+	InterlockedAdd64(reinterpret_cast<volatile LONG64*>(statistic), static_cast<LONG64>(value));
+}
+
+class Sha256
+{
+public:
+	Sha256()
+	{
+		const NTSTATUS status = BCryptCreateHash(BCRYPT_SHA256_ALG_HANDLE, &Handle, nullptr, 0, nullptr, 0, 0);
+		CHECK(BCRYPT_SUCCESS(status));
+	}
+
+	~Sha256()
+	{
+		BCryptDestroyHash(Handle);
+	}
+
+	void Add(const void* data, usize size)
+	{
+		const NTSTATUS status = BCryptHashData(Handle, static_cast<PUCHAR>(const_cast<void*>(data)), static_cast<ULONG>(size), 0);
+		CHECK(BCRYPT_SUCCESS(status));
+	}
+
+	CacheKey Finish()
+	{
+		CacheKey key = {};
+		const NTSTATUS status = BCryptFinishHash(Handle, key.Bytes, sizeof(key.Bytes), 0);
+		CHECK(BCRYPT_SUCCESS(status));
+		return key;
+	}
+
+private:
+	BCRYPT_HASH_HANDLE Handle;
+};
+
+static bool ReadEntireFile(const wchar_t* path, Array<uint8>* contents)
+{
+	const HANDLE file = CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize = {};
+	bool success = GetFileSizeEx(file, &fileSize) != 0;
+	if (success)
+	{
+		contents->GrowToLengthUninitialized(static_cast<usize>(fileSize.QuadPart));
+
+		DWORD bytesRead = 0;
+		success = ::ReadFile(file, contents->GetData(), static_cast<DWORD>(fileSize.QuadPart), &bytesRead, nullptr) &&
+				  bytesRead == static_cast<DWORD>(fileSize.QuadPart);
+	}
+	CloseHandle(file);
+	return success;
+}
+
+static void GetCachePath(const CacheKey& key, wchar_t* path, usize pathLength)
+{
+	wchar_t name[CacheKeySize * 2 + 1] = {};
+	for (usize i = 0; i < CacheKeySize; ++i)
+	{
+		static constexpr wchar_t hexDigits[] = L"0123456789abcdef";
+		name[i * 2 + 0] = hexDigits[key.Bytes[i] >> 4];
+		name[i * 2 + 1] = hexDigits[key.Bytes[i] & 0xF];
+	}
+	swprintf_s(path, pathLength, L"%s\\%s.bin", CacheDirectory, name);
+}
+
+static bool IsSameKey(const CacheKey& a, const CacheKey& b)
+{
+	for (usize i = 0; i < CacheKeySize; ++i)
+	{
+		if (a.Bytes[i] != b.Bytes[i])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool IsDependencyCurrent(const CacheDependency& dependency)
+{
+	Array<uint8> contents(RHI::Allocator);
+	if (!ReadEntireFile(dependency.Path, &contents))
+	{
+		return false;
+	}
+	return IsSameKey(HashBytes(contents.GetData(), contents.GetLength()), dependency.Hash);
+}
+
+IncludeRecorder::IncludeRecorder(IDxcIncludeHandler* includeHandler, Array<CacheDependency>* dependencies)
+	: IncludeHandler(includeHandler)
+	, Dependencies(dependencies)
+{
+}
+
+HRESULT STDMETHODCALLTYPE IncludeRecorder::LoadSource(LPCWSTR fileName, IDxcBlob** includeSource)
+{
+	const HRESULT result = IncludeHandler->LoadSource(fileName, includeSource);
+	if (SUCCEEDED(result) && *includeSource)
+	{
+		CacheDependency dependency = {};
+		wcsncpy_s(dependency.Path, fileName, _TRUNCATE);
+		dependency.Hash = HashBytes((*includeSource)->GetBufferPointer(), (*includeSource)->GetBufferSize());
+		Dependencies->Add(dependency);
+	}
+	return result;
+}
+
+HRESULT STDMETHODCALLTYPE IncludeRecorder::QueryInterface(REFIID id, void** object)
+{
+	if (id == __uuidof(IDxcIncludeHandler) || id == __uuidof(IUnknown))
+	{
+		*object = this;
+		return S_OK;
+	}
+	*object = nullptr;
+	return E_NOINTERFACE;
+}
+
+void InitCache(const wchar_t* directory, usize maximumSize, IDxcCompiler3* compiler)
+{
+	CacheStatistics = {};
+	if (!directory || directory[0] == L'\0')
+	{
+		CacheDirectory[0] = L'\0';
+		return;
+	}
+
+	wcsncpy_s(CacheDirectory, directory, _TRUNCATE);
+	CacheMaximumSize = maximumSize != 0 ? maximumSize : DefaultCacheSize;
+
+	const bool created = CreateDirectoryW(CacheDirectory, nullptr) || GetLastError() == ERROR_ALREADY_EXISTS;
+	VERIFY(created, "Failed to create the shader cache directory!");
+
+	IDxcVersionInfo* versionInfo = nullptr;
+	if (SUCCEEDED(compiler->QueryInterface(IID_PPV_ARGS(&versionInfo))))
+	{
+		CHECK_RESULT(versionInfo->GetVersion(&CompilerVersion[0], &CompilerVersion[1]));
+		SAFE_RELEASE(versionInfo);
+	}
+}
+
+void ShutdownCache()
+{
+	if (!IsCacheEnabled())
+	{
+		return;
+	}
+
+	wchar_t pattern[MAX_PATH] = {};
+	swprintf_s(pattern, ARRAY_COUNT(pattern), L"%s\\*.bin", CacheDirectory);
+
+	Array<CacheFile> files(RHI::Allocator);
+	usize totalSize = 0;
+
+	WIN32_FIND_DATAW findData = {};
+	const HANDLE find = FindFirstFileW(pattern, &findData);
+	if (find != INVALID_HANDLE_VALUE)
+	{
+		do
+		{
+			CacheFile file = {};
+			wcsncpy_s(file.Name, findData.cFileName, _TRUNCATE);
+			file.Size = (static_cast<uint64>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow;
+			file.LastAccess = (static_cast<uint64>(findData.ftLastWriteTime.dwHighDateTime) << 32) | findData.ftLastWriteTime.dwLowDateTime;
+			files.Add(file);
+			totalSize += file.Size;
+		} while (FindNextFileW(find, &findData));
+		FindClose(find);
+	}
+
+	while (totalSize > CacheMaximumSize)
+	{
+		usize leastRecentIndex = 0;
+		for (usize fileIndex = 1; fileIndex < files.GetLength(); ++fileIndex)
+		{
+			if (files[fileIndex].LastAccess < files[leastRecentIndex].LastAccess)
+			{
+				leastRecentIndex = fileIndex;
+			}
+		}
+
+		CacheFile& leastRecent = files[leastRecentIndex];
+		wchar_t path[MAX_PATH] = {};
+		swprintf_s(path, ARRAY_COUNT(path), L"%s\\%s", CacheDirectory, leastRecent.Name);
+		DeleteFileW(path);
+
+		totalSize -= leastRecent.Size;
+		AddStatistic(&CacheStatistics.BytesEvicted, leastRecent.Size);
+		leastRecent.LastAccess = 0xFFFFFFFFFFFFFFFF;
+		leastRecent.Size = 0;
+	}
+}
+
+bool IsCacheEnabled()
+{
+	return CacheDirectory[0] != L'\0';
+}
+
+CacheKey HashBytes(const void* data, usize size)
+{
+	Sha256 hash;
+	hash.Add(data, size);
+	return hash.Finish();
+}
+
+CacheKey HashCompile(IDxcCompilerArgs* arguments, const DxcBuffer& source)
+{
+	Sha256 hash;
+	hash.Add(&CacheVersion, sizeof(CacheVersion));
+	hash.Add(CompilerVersion, sizeof(CompilerVersion));
+
+	LPCWSTR* argumentList = arguments->GetArguments();
+	for (uint32 argumentIndex = 0; argumentIndex < arguments->GetCount(); ++argumentIndex)
+	{
+		hash.Add(argumentList[argumentIndex], (wcslen(argumentList[argumentIndex]) + 1) * sizeof(wchar_t));
+	}
+
+	hash.Add(source.Ptr, source.Size);
+	return hash.Finish();
+}
+
+bool LoadCache(const CacheKey& key,
+			   IDxcUtils* utils,
+			   IDxcBlob** blob,
+			   RHI::ShaderReflection* reflection,
+			   Array<CacheDependency>* dependencies)
+{
+	if (!IsCacheEnabled())
+	{
+		return false;
+	}
+
+	wchar_t path[MAX_PATH] = {};
+	GetCachePath(key, path, ARRAY_COUNT(path));
+
+	Array<uint8> contents(RHI::Allocator);
+	if (!ReadEntireFile(path, &contents) || contents.GetLength() < sizeof(CacheHeader))
+	{
+		AddStatistic(&CacheStatistics.Misses, 1);
+		return false;
+	}
+
+	CacheHeader header = {};
+	Platform::MemoryCopy(&header, contents.GetData(), sizeof(header));
+
+	const usize dependenciesSize = header.DependencyCount * sizeof(CacheDependency);
+	const bool validHeader = header.Magic == CacheMagic &&
+							 header.Version == CacheVersion &&
+							 header.ReflectionSize == sizeof(RHI::ShaderReflection) &&
+							 contents.GetLength() == sizeof(header) + dependenciesSize + header.BlobSize + header.ReflectionSize;
+	if (!validHeader)
+	{
+		AddStatistic(&CacheStatistics.Misses, 1);
+		return false;
+	}
+
+	const uint8* dependencyData = contents.GetData() + sizeof(header);
+	const uint8* cursor = dependencyData;
+	for (uint32 dependencyIndex = 0; dependencyIndex < header.DependencyCount; ++dependencyIndex)
+	{
+		CacheDependency dependency = {};
+		Platform::MemoryCopy(&dependency, cursor, sizeof(dependency));
+		cursor += sizeof(dependency);
+
+		if (!IsDependencyCurrent(dependency))
+		{
+			AddStatistic(&CacheStatistics.Misses, 1);
+			return false;
+		}
+	}
+
+	for (uint32 dependencyIndex = 0; dependencyIndex < header.DependencyCount; ++dependencyIndex)
+	{
+		CacheDependency dependency = {};
+		Platform::MemoryCopy(&dependency, dependencyData + dependencyIndex * sizeof(dependency), sizeof(dependency));
+		dependencies->Add(dependency);
+	}
+
+	IDxcBlobEncoding* blobEncoding = nullptr;
+	CHECK_RESULT(utils->CreateBlob(cursor, static_cast<uint32>(header.BlobSize), DXC_CP_ACP, &blobEncoding));
+	cursor += header.BlobSize;
+
+	Platform::MemoryCopy(reflection, cursor, sizeof(RHI::ShaderReflection));
+
+	*blob = blobEncoding;
+
+	const HANDLE file = CreateFileW(path, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		FILETIME now = {};
+		GetSystemTimeAsFileTime(&now);
+		SetFileTime(file, nullptr, nullptr, &now);
+		CloseHandle(file);
+	}
+
+	AddStatistic(&CacheStatistics.Hits, 1);
+	AddStatistic(&CacheStatistics.BytesRead, contents.GetLength());
+	return true;
+}
+
+void StoreCache(const CacheKey& key,
+				const Array<CacheDependency>& dependencies,
+				IDxcBlob* blob,
+				const RHI::ShaderReflection& reflection)
+{
+	if (!IsCacheEnabled())
+	{
+		return;
+	}
+
+	const CacheHeader header =
+	{
+		.Magic = CacheMagic,
+		.Version = CacheVersion,
+		.DependencyCount = static_cast<uint32>(dependencies.GetLength()),
+		.Reserved = 0,
+		.BlobSize = blob->GetBufferSize(),
+		.ReflectionSize = sizeof(reflection),
+	};
+
+	wchar_t path[MAX_PATH] = {};
+	GetCachePath(key, path, ARRAY_COUNT(path));
+
+	wchar_t temporaryPath[MAX_PATH] = {};
+	swprintf_s(temporaryPath, ARRAY_COUNT(temporaryPath), L"%s.%lu.tmp", path, GetCurrentThreadId());
+
+	const HANDLE file = CreateFileW(temporaryPath, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+
+	const struct
+	{
+		const void* Data;
+		usize Size;
+	} chunks[] =
+	{
+		{ &header, sizeof(header) },
+		{ dependencies.GetData(), dependencies.GetLength() * sizeof(CacheDependency) },
+		{ blob->GetBufferPointer(), blob->GetBufferSize() },
+		{ &reflection, sizeof(reflection) },
+	};
+
+	bool success = true;
+	usize bytesWritten = 0;
+	for (const auto& chunk : chunks)
+	{
+		DWORD chunkBytesWritten = 0;
+		success = success && ::WriteFile(file, chunk.Data, static_cast<DWORD>(chunk.Size), &chunkBytesWritten, nullptr);
+		bytesWritten += chunkBytesWritten;
+	}
+	CloseHandle(file);
+
+	if (success && MoveFileExW(temporaryPath, path, MOVEFILE_REPLACE_EXISTING))
+	{
+		AddStatistic(&CacheStatistics.BytesWritten, bytesWritten);
+	}
+	else
+	{
+		DeleteFileW(temporaryPath);
+	}
+}
+
+RHI::ShaderCacheStatistics GetCacheStatistics()
+{
+	return CacheStatistics;
+}
+
+}
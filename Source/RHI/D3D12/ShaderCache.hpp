@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Base.hpp"
+
+#include "RHI/Shader.hpp"
+#include "RHI/ShaderReflection.hpp"
+
+#include "Luft/Array.hpp"
+
+#include "dxc/dxcapi.h"
+
+namespace DXC
+{
+
+inline constexpr usize CacheKeySize = 32;
+
+struct CacheKey
+{
+	uint8 Bytes[CacheKeySize];
+};
+
+struct CacheDependency
+{
+	wchar_t Path[MAX_PATH];
+	CacheKey Hash;
+};
+
+class IncludeRecorder final : public IDxcIncludeHandler
+{
+public:
+	IncludeRecorder(IDxcIncludeHandler* includeHandler, Array<CacheDependency>* dependencies);
+
+	virtual HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR fileName, IDxcBlob** includeSource) override;
+
+	virtual HRESULT STDMETHODCALLTYPE QueryInterface(REFIID id, void** object) override;
+	virtual ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+	virtual ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+	IDxcIncludeHandler* IncludeHandler;
+	Array<CacheDependency>* Dependencies;
+};
+
+void InitCache(const wchar_t* directory, usize maximumSize, IDxcCompiler3* compiler);
+void ShutdownCache();
+
+bool IsCacheEnabled();
+
+CacheKey HashBytes(const void* data, usize size);
+CacheKey HashCompile(IDxcCompilerArgs* arguments, const DxcBuffer& source);
+
+bool LoadCache(const CacheKey& key,
+			   IDxcUtils* utils,
+			   IDxcBlob** blob,
+			   RHI::ShaderReflection* reflection,
+			   Array<CacheDependency>* dependencies);
+void StoreCache(const CacheKey& key,
+				const Array<CacheDependency>& dependencies,
+				IDxcBlob* blob,
+				const RHI::ShaderReflection& reflection);
+
+RHI::ShaderCacheStatistics GetCacheStatistics();
+
+}
@@ -0,0 +1,156 @@
+#include "ShaderReflection.hpp"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#endif
+#include "dxc/dxcapi.h"
+#include "dxc/d3d12shader.h"
+
+#include <cstring>
+
+namespace DXC
+{
+
+static bool CopyName(const char* name, char* destination)
+{
+	const usize nameLength = strlen(name);
+	if (nameLength >= RHI::MaxReflectedNameLength)
+	{
+		return false;
+	}
+
+	memcpy(destination, name, nameLength + 1);
+	return true;
+}
+
+bool DistillReflection(ID3D12ShaderReflection* shaderReflection, RHI::ShaderReflection* reflection)
+{
+	memset(reflection, 0, sizeof(*reflection));
+
+	D3D12_SHADER_DESC shaderDescription = {};
+	if (FAILED(shaderReflection->GetDesc(&shaderDescription)))
+	{
+		return false;
+	}
+
+	for (uint32 i = 0; i < shaderDescription.InputParameters; ++i)
+	{
+		D3D12_SIGNATURE_PARAMETER_DESC inputParameterDescription = {};
+		if (FAILED(shaderReflection->GetInputParameterDesc(i, &inputParameterDescription)))
+		{
+			return false;
+		}
+
+		const bool systemValue = inputParameterDescription.SystemValueType != D3D_NAME_UNDEFINED;
+		if (systemValue)
+		{
+			continue;
+		}
+
+		if (reflection->InputElementCount == RHI::MaxReflectedInputElements)
+		{
+			return false;
+		}
+
+		RHI::ReflectedInputElement& inputElement = reflection->InputElements[reflection->InputElementCount++];
+		if (!CopyName(inputParameterDescription.SemanticName, inputElement.SemanticName))
+		{
+			return false;
+		}
+		inputElement.SemanticIndex = inputParameterDescription.SemanticIndex;
+		inputElement.ComponentMask = inputParameterDescription.Mask;
+		switch (inputParameterDescription.ComponentType)
+		{
+		case D3D_REGISTER_COMPONENT_FLOAT32:
+			inputElement.ComponentType = RHI::ReflectedComponentType::Float32;
+			break;
+		case D3D_REGISTER_COMPONENT_FLOAT16:
+			inputElement.ComponentType = RHI::ReflectedComponentType::Float16;
+			break;
+		case D3D_REGISTER_COMPONENT_UINT32:
+			inputElement.ComponentType = RHI::ReflectedComponentType::UInt32;
+			break;
+		case D3D_REGISTER_COMPONENT_SINT32:
+			inputElement.ComponentType = RHI::ReflectedComponentType::SInt32;
+			break;
+		case D3D_REGISTER_COMPONENT_UINT16:
+			inputElement.ComponentType = RHI::ReflectedComponentType::UInt16;
+			break;
+		case D3D_REGISTER_COMPONENT_SINT16:
+			inputElement.ComponentType = RHI::ReflectedComponentType::SInt16;
+			break;
+		default:
+			return false;
+		}
+		inputElement.Slot = inputParameterDescription.Register;
+	}
+
+	if (shaderDescription.BoundResources > RHI::MaxReflectedBindings)
+	{
+		return false;
+	}
+
+	for (uint32 i = 0; i < shaderDescription.BoundResources; ++i)
+	{
+		D3D12_SHADER_INPUT_BIND_DESC resourceDescription = {};
+		if (FAILED(shaderReflection->GetResourceBindingDesc(i, &resourceDescription)))
+		{
+			return false;
+		}
+
+		// Root descriptors can only address buffers, so textures and typed buffers must come from the heaps.
+		RHI::ReflectedBindingType type = RHI::ReflectedBindingType::ConstantBuffer;
+		uint32 size = 0;
+		switch (resourceDescription.Type)
+		{
+		case D3D_SIT_CBUFFER:
+		{
+			D3D12_SHADER_VARIABLE_DESC variableDescription = {};
+			ID3D12ShaderReflectionVariable* variable = shaderReflection->GetVariableByName(resourceDescription.Name);
+			if (!variable || FAILED(variable->GetDesc(&variableDescription)))
+			{
+				return false;
+			}
+			type = strcmp(resourceDescription.Name, "RootConstants") == 0 ? RHI::ReflectedBindingType::RootConstants
+																		   : RHI::ReflectedBindingType::ConstantBuffer;
+			size = variableDescription.Size;
+			break;
+		}
+		case D3D_SIT_STRUCTURED:
+		case D3D_SIT_BYTEADDRESS:
+			type = RHI::ReflectedBindingType::ShaderResource;
+			break;
+		case D3D_SIT_UAV_RWSTRUCTURED:
+		case D3D_SIT_UAV_RWBYTEADDRESS:
+			type = RHI::ReflectedBindingType::UnorderedAccess;
+			break;
+		case D3D_SIT_SAMPLER:
+			if (resourceDescription.Space != RHI::StaticSamplerSpace || resourceDescription.BindPoint >= RHI::StaticSamplerCount)
+			{
+				return false;
+			}
+			type = RHI::ReflectedBindingType::StaticSampler;
+			break;
+		default:
+			return false;
+		}
+
+		// Bindings keep their reflection order. Every one but the static samplers takes the next root parameter.
+		RHI::ReflectedBinding& binding = reflection->Bindings[reflection->BindingCount++];
+		if (!CopyName(resourceDescription.Name, binding.Name))
+		{
+			return false;
+		}
+		binding.Type = type;
+		binding.Register = resourceDescription.BindPoint;
+		binding.Space = resourceDescription.Space;
+		binding.Size = size;
+	}
+
+	shaderReflection->GetThreadGroupSize(&reflection->ThreadGroupSize[0],
+										 &reflection->ThreadGroupSize[1],
+										 &reflection->ThreadGroupSize[2]);
+	return true;
+}
+
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "RHI/ShaderReflection.hpp"
+
+struct ID3D12ShaderReflection;
+
+namespace DXC
+{
+
+// Also built into the ShaderArchiver, so this only depends on DXC and not on the rest of the backend. Returns false
+// when the shader binds something the table cannot describe.
+bool DistillReflection(ID3D12ShaderReflection* shaderReflection, RHI::ShaderReflection* reflection);
+
+}
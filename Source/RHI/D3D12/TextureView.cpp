@@ -29,6 +29,7 @@ TextureView::TextureView(const TextureViewDescription& description, D3D12::Devic
 
 		const D3D12_UNORDERED_ACCESS_VIEW_DESC unorderedAccessDescription = To<ViewType::UnorderedAccess>(description);
 		device->Native->CreateUnorderedAccessView(backendResource->Native, nullptr, &unorderedAccessDescription, GetCpu());
+		device->Native->CreateUnorderedAccessView(backendResource->Native, nullptr, &unorderedAccessDescription, GetClearCpu());
 		break;
 	}
 	case ViewType::RenderTarget:
@@ -62,4 +63,10 @@ D3D12_GPU_DESCRIPTOR_HANDLE TextureView::GetGpu() const
 	return Device->GetGpu(HeapIndex, Type);
 }
 
+D3D12_CPU_DESCRIPTOR_HANDLE TextureView::GetClearCpu() const
+{
+	CHECK(Type == ViewType::UnorderedAccess);
+	return Device->UnorderedAccessClearViewHeap.GetCpu(HeapIndex);
+}
+
 }
@@ -6,9 +6,12 @@
 #include "D3D12/BufferView.hpp"
 #include "D3D12/ComputePipeline.hpp"
 #include "D3D12/Device.hpp"
+#include "D3D12/Fence.hpp"
 #include "D3D12/GraphicsContext.hpp"
 #include "D3D12/GraphicsPipeline.hpp"
 #include "D3D12/Heap.hpp"
+#include "D3D12/QueryPool.hpp"
+#include "D3D12/ReadbackRing.hpp"
 #include "D3D12/Resource.hpp"
 #include "D3D12/Sampler.hpp"
 #include "D3D12/TextureView.hpp"
@@ -17,8 +20,8 @@
 namespace RHI
 {
 
-Device::Device(const Platform::Window* window)
-	: Backend(Allocator->Create<RHI_BACKEND(Device)>(window))
+Device::Device(const DeviceDescription& description)
+	: Backend(Allocator->Create<RHI_BACKEND(Device)>(description))
 {
 }
 
@@ -43,6 +46,11 @@ ComputePipeline Device::Create(const ComputePipelineDescription& description) co
 	return ComputePipeline(description, Backend->Create(description));
 }
 
+Fence Device::Create(const FenceDescription& description) const
+{
+	return Fence(description, Backend->Create(description));
+}
+
 GraphicsContext Device::Create(const GraphicsContextDescription& description) const
 {
 	return GraphicsContext(description, Backend->Create(description));
@@ -53,11 +61,28 @@ GraphicsPipeline Device::Create(const GraphicsPipelineDescription& description)
 	return GraphicsPipeline(description, Backend->Create(description));
 }
 
+GraphicsPipeline Device::CreateAsync(const GraphicsPipelineDescription& description,
+									 PipelinePriority priority,
+									 const GraphicsPipeline& fallback) const
+{
+	return GraphicsPipeline(description, Backend->CreateAsync(description, priority, fallback.Backend));
+}
+
 Heap Device::Create(const HeapDescription& description) const
 {
 	return Heap(description, Backend->Create(description));
 }
 
+QueryPool Device::Create(const QueryPoolDescription& description) const
+{
+	return QueryPool(description, Backend->Create(description));
+}
+
+ReadbackRing Device::Create(const ReadbackRingDescription& description) const
+{
+	return ReadbackRing(description, Backend->Create(description));
+}
+
 Resource Device::Create(const ResourceDescription& description) const
 {
 	return Resource(description, Backend->Create(description));
@@ -73,6 +98,31 @@ Shader Device::Create(const ShaderDescription& description) const
 	return Shader(description, Backend->Create(description));
 }
 
+Array<Shader> Device::Create(ArrayView<const ShaderDescription> descriptions, Array<String>* errors) const
+{
+	Array<Shader> shaders(descriptions.GetLength(), Allocator);
+	if (descriptions.GetLength() == 0)
+	{
+		return shaders;
+	}
+
+	const usize firstError = errors->GetLength();
+	for (usize i = 0; i < descriptions.GetLength(); ++i)
+	{
+		errors->Add(String(0, Allocator));
+	}
+
+	Array<RHI_BACKEND(Shader)*> backends(descriptions.GetLength(), Allocator);
+	backends.GrowToLengthUninitialized(descriptions.GetLength());
+	Backend->Create(descriptions, backends.GetData(), &(*errors)[firstError]);
+
+	for (usize i = 0; i < descriptions.GetLength(); ++i)
+	{
+		shaders.Add(Shader(descriptions[i], backends[i]));
+	}
+	return shaders;
+}
+
 TextureView Device::Create(const TextureViewDescription& description) const
 {
 	return TextureView(description, Backend->Create(description));
@@ -96,6 +146,12 @@ void Device::Destroy(ComputePipeline* computePipeline) const
 	computePipeline->Backend = nullptr;
 }
 
+void Device::Destroy(Fence* fence) const
+{
+	Backend->Destroy(fence->Backend);
+	fence->Backend = nullptr;
+}
+
 void Device::Destroy(GraphicsContext* graphicsContext) const
 {
 	Backend->Destroy(graphicsContext->Backend);
@@ -114,6 +170,18 @@ void Device::Destroy(Heap* heap) const
 	heap->Backend = nullptr;
 }
 
+void Device::Destroy(QueryPool* queryPool) const
+{
+	Backend->Destroy(queryPool->Backend);
+	queryPool->Backend = nullptr;
+}
+
+void Device::Destroy(ReadbackRing* readbackRing) const
+{
+	Backend->Destroy(readbackRing->Backend);
+	readbackRing->Backend = nullptr;
+}
+
 void Device::Destroy(Resource* resource) const
 {
 	Backend->Destroy(resource->Backend);
@@ -138,6 +206,11 @@ void Device::Destroy(TextureView* textureView) const
 	textureView->Backend = nullptr;
 }
 
+void Device::ReleaseBytecode(const Shader& shader) const
+{
+	Backend->ReleaseBytecode(shader.Backend);
+}
+
 uint32 Device::Get(const AccelerationStructure& accelerationStructure)
 {
 	return accelerationStructure.Backend->HeapIndex;
@@ -163,11 +236,31 @@ void Device::Write(const Resource* write, const ResourceDescription& format, con
 	Backend->Write(write->Backend, format, data);
 }
 
+void Device::Write(const SubBuffer& write, const void* data) const
+{
+	Backend->Write(write.Resource.Backend, write.Offset, write.Size, data);
+}
+
+void Device::Read(const Resource* read, usize offset, usize size, void* data) const
+{
+	Backend->Read(read->Backend, offset, size, data);
+}
+
 void Device::Submit(const GraphicsContext& context) const
 {
 	Backend->Submit(context.Backend);
 }
 
+void Device::Signal(const Fence& fence, uint64 value) const
+{
+	Backend->Signal(fence.Backend, value);
+}
+
+void Device::Wait(const Fence& fence, uint64 value) const
+{
+	Backend->Wait(fence.Backend, value);
+}
+
 void Device::Present()
 {
 	Backend->Present();
@@ -178,6 +271,11 @@ void Device::WaitForIdle()
 	Backend->WaitForIdle();
 }
 
+void Device::WaitForFrameLatency() const
+{
+	Backend->WaitForFrameLatency();
+}
+
 void Device::ResizeSwapChain(uint32 width, uint32 height)
 {
 	Backend->ResizeSwapChain(width, height);
@@ -188,6 +286,66 @@ usize Device::GetFrameIndex() const
 	return Backend->GetFrameIndex();
 }
 
+usize Device::GetFramesInFlight() const
+{
+	return Backend->FramesInFlight;
+}
+
+uint64 Device::GetFrameCount() const
+{
+	return Backend->FrameCount;
+}
+
+bool Device::IsHeadless() const
+{
+	return Backend->IsHeadless();
+}
+
+double Device::GetMostRecentFrameWaitTime() const
+{
+	return Backend->MostRecentFrameWaitTime;
+}
+
+ShaderCacheStatistics Device::GetShaderCacheStatistics() const
+{
+	return Backend->GetShaderCacheStatistics();
+}
+
+ShaderArchiveStatistics Device::GetShaderArchiveStatistics() const
+{
+	return Backend->GetShaderArchiveStatistics();
+}
+
+bool Device::IsReady(const GraphicsPipeline& graphicsPipeline) const
+{
+	return graphicsPipeline.Backend->IsReady();
+}
+
+void Device::SavePipelineCache() const
+{
+	Backend->SavePipelineCache();
+}
+
+PipelineCacheStatistics Device::GetPipelineCacheStatistics() const
+{
+	return Backend->GetPipelineCacheStatistics();
+}
+
+void Device::WarmUpPipelines() const
+{
+	Backend->WarmUpPipelines();
+}
+
+PipelineWarmUpStatistics Device::GetPipelineWarmUpStatistics() const
+{
+	return Backend->GetPipelineWarmUpStatistics();
+}
+
+ObjectCacheStatistics Device::GetObjectCacheStatistics() const
+{
+	return Backend->GetObjectCacheStatistics();
+}
+
 usize Device::GetResourceSize(const ResourceDescription& description) const
 {
 	return Backend->GetResourceSize(description);
@@ -3,10 +3,13 @@
 #include "AccelerationStructure.hpp"
 #include "BufferView.hpp"
 #include "ComputePipeline.hpp"
+#include "Fence.hpp"
 #include "Forward.hpp"
 #include "GraphicsContext.hpp"
 #include "GraphicsPipeline.hpp"
 #include "Heap.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 #include "Resource.hpp"
 #include "Sampler.hpp"
 #include "Shader.hpp"
@@ -15,36 +18,133 @@
 namespace RHI
 {
 
-inline constexpr usize FramesInFlight = 2;
+inline constexpr usize MinFramesInFlight = 2;
+inline constexpr usize MaxFramesInFlight = 4;
+inline constexpr usize DefaultFramesInFlight = MinFramesInFlight;
+
+struct DeviceDescription
+{
+	// A null window creates a headless device: no swap chain is made and Present only marks the frame boundary.
+	const Platform::Window* Window;
+
+	usize FramesInFlight;
+
+	// An empty path disables the on-disk shader cache. A zero size uses the default limit.
+	StringView ShaderCachePath;
+	usize ShaderCacheSize;
+
+	// Development builds only: a directory watched for shader edits. Shaders that include a changed file recompile in the
+	// background and the pipelines built from them are swapped at the next Present. An empty path disables hot reload.
+	StringView ShaderHotReloadPath;
+
+	// An archive built by the ShaderArchiver tool. Shaders found in it are never compiled at runtime.
+	StringView ShaderArchivePath;
+
+	// A file every shader and pipeline description created is recorded to, for WarmUpPipelines to build in a later
+	// session. An empty path disables recording.
+	StringView PipelineManifestPath;
+
+	// A file the driver's compiled pipelines are loaded from and saved to when the device is destroyed. It is rebuilt
+	// from scratch after a driver update. An empty path disables it.
+	StringView PipelineCachePath;
+};
+
+struct PipelineCacheStatistics
+{
+	usize Hits;
+	usize Misses;
+
+	double HitTime;
+	double MissTime;
+
+	usize BytesRead;
+	usize BytesWritten;
+};
+
+// Creates with a description equal to a live object's return that object instead of a new one. BytesSaved counts the
+// objects and descriptors those duplicates would have used.
+struct ObjectCacheCounters
+{
+	usize Hits;
+	usize Misses;
+	usize Live;
+	usize BytesSaved;
+};
+
+struct ObjectCacheStatistics
+{
+	ObjectCacheCounters Samplers;
+	ObjectCacheCounters TextureViews;
+	ObjectCacheCounters BufferViews;
+	ObjectCacheCounters GraphicsPipelines;
+};
+
+struct PipelineWarmUpStatistics
+{
+	// Distinct shaders and pipelines in the manifest, including the ones recorded this session.
+	usize Recorded;
+
+	// Pipelines built by WarmUpPipelines, how many of those were then created by the application, and how many pipelines
+	// the application created that were not prewarmed.
+	usize Prewarmed;
+	usize PrewarmedUsed;
+	usize Late;
+
+	double WarmUpTime;
+};
 
 class Device : public NoCopy
 {
 public:
-	explicit Device(const Platform::Window* window);
+	explicit Device(const DeviceDescription& description);
 	~Device();
 
 	AccelerationStructure Create(const AccelerationStructureDescription& description) const;
 	BufferView Create(const BufferViewDescription& description) const;
 	ComputePipeline Create(const ComputePipelineDescription& description) const;
+	Fence Create(const FenceDescription& description) const;
 	GraphicsContext Create(const GraphicsContextDescription& description) const;
 	GraphicsPipeline Create(const GraphicsPipelineDescription& description) const;
+
+	// Returns at once and builds the pipeline on background threads, higher priorities first. Until it is ready, setting
+	// it on a context sets the fallback instead, which must already be ready and bind the same names. Without a fallback,
+	// setting it waits for the build, doing the work on the calling thread if no worker has started it yet.
+	GraphicsPipeline CreateAsync(const GraphicsPipelineDescription& description,
+								 PipelinePriority priority,
+								 const GraphicsPipeline& fallback = GraphicsPipeline::Invalid()) const;
+	bool IsReady(const GraphicsPipeline& graphicsPipeline) const;
+
 	Heap Create(const HeapDescription& description) const;
+	QueryPool Create(const QueryPoolDescription& description) const;
+	ReadbackRing Create(const ReadbackRingDescription& description) const;
 	Resource Create(const ResourceDescription& description) const;
 	Sampler Create(const SamplerDescription& description) const;
 	Shader Create(const ShaderDescription& description) const;
+
+	// Compiles across all cores. Shaders come back in order; one that fails is invalid and its compiler output is
+	// appended to errors at the same position, with an empty string for every shader that succeeded.
+	Array<Shader> Create(ArrayView<const ShaderDescription> descriptions, Array<String>* errors) const;
+
 	TextureView Create(const TextureViewDescription& description) const;
 
 	void Destroy(AccelerationStructure* accelerationStructure) const;
 	void Destroy(BufferView* bufferView) const;
 	void Destroy(ComputePipeline* computePipeline) const;
+	void Destroy(Fence* fence) const;
 	void Destroy(GraphicsContext* graphicsContext) const;
 	void Destroy(GraphicsPipeline* graphicsPipeline) const;
 	void Destroy(Heap* heap) const;
+	void Destroy(QueryPool* queryPool) const;
+	void Destroy(ReadbackRing* readbackRing) const;
 	void Destroy(Resource* resource) const;
 	void Destroy(Sampler* sampler) const;
 	void Destroy(Shader* shader) const;
 	void Destroy(TextureView* textureView) const;
 
+	// Frees the DXIL once every pipeline using the shader has been created. The binding table stays, but the shader can
+	// no longer be used to create pipelines. Does nothing while shader hot reload is enabled.
+	void ReleaseBytecode(const Shader& shader) const;
+
 	uint32 Get(const AccelerationStructure& accelerationStructure);
 	uint32 Get(const BufferView& buffer) const;
 	uint32 Get(const Sampler& sampler) const;
@@ -53,13 +153,43 @@ public:
 	void Write(const Resource* write, const ResourceDescription& format, const void* data) const;
 	void Write(const Resource* write, const void* data) const { Write(write, *write, data); }
 
+	// Writes Size bytes at Offset into an upload buffer, leaving the rest of it untouched.
+	void Write(const SubBuffer& write, const void* data) const;
+
+	void Read(const Resource* read, usize offset, usize size, void* data) const;
+
 	void Submit(const GraphicsContext& context) const;
+	void Signal(const Fence& fence, uint64 value) const;
+	void Wait(const Fence& fence, uint64 value) const;
 	void Present();
 	void WaitForIdle();
+	void WaitForFrameLatency() const;
 
 	void ResizeSwapChain(uint32 width, uint32 height);
 
 	usize GetFrameIndex() const;
+	usize GetFramesInFlight() const;
+	// Counts presented frames. Unlike the frame index it never repeats, even with a single frame in flight.
+	uint64 GetFrameCount() const;
+	bool IsHeadless() const;
+
+	double GetMostRecentFrameWaitTime() const;
+
+	ShaderCacheStatistics GetShaderCacheStatistics() const;
+	ShaderArchiveStatistics GetShaderArchiveStatistics() const;
+
+	// Writes out the pipelines created since the last save. Must not run while pipelines are being created.
+	void SavePipelineCache() const;
+	PipelineCacheStatistics GetPipelineCacheStatistics() const;
+
+	// Builds every shader and pipeline recorded in earlier sessions across all cores and blocks until they are done,
+	// so call it while loading. Pipelines created afterwards with a matching description reuse the prewarmed state.
+	void WarmUpPipelines() const;
+	PipelineWarmUpStatistics GetPipelineWarmUpStatistics() const;
+
+	// Creating a sampler, view or graphics pipeline with the same description as a live one returns that one. Every
+	// Create still needs its own Destroy, and the object goes away with the last.
+	ObjectCacheStatistics GetObjectCacheStatistics() const;
 
 	usize GetResourceSize(const ResourceDescription& description) const;
 	usize GetResourceAlignment(const ResourceDescription& description) const;
@@ -0,0 +1,23 @@
+#include "Fence.hpp"
+
+#include "D3D12/Fence.hpp"
+
+namespace RHI
+{
+
+uint64 Fence::GetCompletedValue() const
+{
+	return Backend->GetCompletedValue();
+}
+
+bool Fence::WaitFor(uint64 value, uint32 timeoutMilliseconds) const
+{
+	return Backend->WaitFor(value, timeoutMilliseconds);
+}
+
+double Fence::GetMostRecentWaitTime() const
+{
+	return Backend->MostRecentWaitTime;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Forward.hpp"
+
+#include "Luft/Base.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI
+{
+
+inline constexpr uint32 InfiniteTimeout = 0xFFFFFFFF;
+
+struct FenceDescription
+{
+	uint64 InitialValue;
+
+	StringView Name;
+};
+
+class Fence final : public FenceDescription
+{
+public:
+	Fence()
+		: FenceDescription()
+		, Backend(nullptr)
+	{
+	}
+
+	Fence(const FenceDescription& description, RHI_BACKEND(Fence)* backend)
+		: FenceDescription(description)
+		, Backend(backend)
+	{
+	}
+
+	static Fence Invalid() { return {}; }
+	bool IsValid() const { return Backend != nullptr; }
+
+	uint64 GetCompletedValue() const;
+	bool WaitFor(uint64 value, uint32 timeoutMilliseconds = InfiniteTimeout) const;
+
+	double GetMostRecentWaitTime() const;
+
+	RHI_BACKEND(Fence)* Backend;
+};
+
+}
@@ -13,25 +13,52 @@ struct AccelerationStructureGeometry;
 struct AccelerationStructureDescription;
 struct AccelerationStructureInstance;
 struct AccelerationStructureSize;
+struct BarrierSubresourceRange;
 struct Buffer;
 class BufferView;
 struct BufferViewDescription;
 class ComputePipeline;
 struct ComputePipelineDescription;
+struct DepthBias;
 class Device;
+struct DeviceDescription;
+class Fence;
+struct FenceDescription;
+struct GeometryMesh;
+class GeometryPool;
+struct GeometryPoolDescription;
 class GraphicsContext;
 struct GraphicsContextDescription;
 class GraphicsPipeline;
 struct GraphicsPipelineDescription;
 class Heap;
 struct HeapDescription;
+struct ObjectCacheCounters;
+struct ObjectCacheStatistics;
+struct PipelineCacheStatistics;
+struct PipelineWarmUpStatistics;
+class QueryPool;
+struct QueryPoolDescription;
+class ReadbackRing;
+struct ReadbackRingDescription;
+struct ReadbackTicket;
+struct RenderTargetBlend;
 class Resource;
 struct ResourceDescription;
 class Sampler;
 struct SamplerDescription;
 class Shader;
+struct ShaderArchiveStatistics;
+struct ShaderCacheStatistics;
+struct ShaderAxis;
 struct ShaderDescription;
+class ShaderLibrary;
+struct ShaderPermutationKey;
+struct ShaderPermutationsDescription;
+struct ShaderReflection;
 struct SubBuffer;
+struct TextureRegion;
 class TextureView;
 struct TextureViewDescription;
+struct VertexAttribute;
 }
@@ -0,0 +1,250 @@
+#include "GeometryPool.hpp"
+#include "Allocator.hpp"
+#include "Device.hpp"
+#include "GraphicsContext.hpp"
+
+namespace RHI
+{
+
+GeometryPool::GeometryPool(const GeometryPoolDescription& description, const RHI::Device* device)
+	: GeometryPoolDescription(description)
+	, Device(device)
+	, FreeVertices(Allocator)
+	, FreeIndices(Allocator)
+	, StagingFrame(device->GetFrameCount())
+	, StagingHead(0)
+{
+	CHECK(VertexStride > 0 && VertexCapacity > 0 && IndexCapacity > 0 && StagingSize > 0);
+	CHECK(IndexStride == sizeof(uint16) || IndexStride == sizeof(uint32));
+
+	VertexResource = Device->Create(
+	{
+		.Type = ResourceType::Buffer,
+		.Format = ResourceFormat::None,
+		.Flags = ResourceFlags::None,
+		.InitialLayout = BarrierLayout::Undefined,
+		.Size = VertexStride * VertexCapacity,
+		.Name = Name,
+	});
+	IndexResource = Device->Create(
+	{
+		.Type = ResourceType::Buffer,
+		.Format = ResourceFormat::None,
+		.Flags = ResourceFlags::None,
+		.InitialLayout = BarrierLayout::Undefined,
+		.Size = IndexStride * IndexCapacity,
+		.Name = Name,
+	});
+	StagingResource = Device->Create(
+	{
+		.Type = ResourceType::Buffer,
+		.Format = ResourceFormat::None,
+		.Flags = ResourceFlags::Upload,
+		.InitialLayout = BarrierLayout::Undefined,
+		.Size = StagingSize * Device->GetFramesInFlight(),
+		.Name = Name,
+	});
+
+	FreeVertices.Add(Range { .Offset = 0, .Count = VertexCapacity });
+	FreeIndices.Add(Range { .Offset = 0, .Count = IndexCapacity });
+}
+
+GeometryPool::~GeometryPool()
+{
+	Device->Destroy(&StagingResource);
+	Device->Destroy(&IndexResource);
+	Device->Destroy(&VertexResource);
+}
+
+bool GeometryPool::TakeRange(Array<Range>* ranges, usize count, usize* offset)
+{
+	for (usize i = 0; i < ranges->GetLength(); ++i)
+	{
+		Range& range = (*ranges)[i];
+		if (range.Count >= count)
+		{
+			*offset = range.Offset;
+			range.Offset += count;
+			range.Count -= count;
+			return true;
+		}
+	}
+	return false;
+}
+
+void GeometryPool::ReturnRange(Array<Range>* ranges, usize offset, usize count)
+{
+	Range* before = nullptr;
+	Range* after = nullptr;
+	Range* empty = nullptr;
+	for (usize i = 0; i < ranges->GetLength(); ++i)
+	{
+		Range& range = (*ranges)[i];
+		if (range.Count == 0)
+		{
+			empty = empty ? empty : &range;
+			continue;
+		}
+
+		CHECK(offset + count <= range.Offset || range.Offset + range.Count <= offset);
+		if (range.Offset + range.Count == offset)
+		{
+			before = &range;
+		}
+		else if (range.Offset == offset + count)
+		{
+			after = &range;
+		}
+	}
+
+	if (before && after)
+	{
+		before->Count += count + after->Count;
+		after->Count = 0;
+	}
+	else if (before)
+	{
+		before->Count += count;
+	}
+	else if (after)
+	{
+		after->Offset = offset;
+		after->Count += count;
+	}
+	else if (empty)
+	{
+		*empty = Range { .Offset = offset, .Count = count };
+	}
+	else
+	{
+		ranges->Add(Range { .Offset = offset, .Count = count });
+	}
+}
+
+usize GeometryPool::CountFree(const Array<Range>& ranges)
+{
+	usize count = 0;
+	for (const Range& range : ranges)
+	{
+		count += range.Count;
+	}
+	return count;
+}
+
+GeometryMesh GeometryPool::Allocate(usize vertexCount, usize indexCount)
+{
+	CHECK(vertexCount > 0 && indexCount > 0);
+
+	usize baseVertex = 0;
+	if (!TakeRange(&FreeVertices, vertexCount, &baseVertex))
+	{
+		return GeometryMesh {};
+	}
+
+	usize firstIndex = 0;
+	if (!TakeRange(&FreeIndices, indexCount, &firstIndex))
+	{
+		ReturnRange(&FreeVertices, baseVertex, vertexCount);
+		return GeometryMesh {};
+	}
+
+	return GeometryMesh
+	{
+		.BaseVertex = static_cast<uint32>(baseVertex),
+		.VertexCount = static_cast<uint32>(vertexCount),
+		.FirstIndex = static_cast<uint32>(firstIndex),
+		.IndexCount = static_cast<uint32>(indexCount),
+	};
+}
+
+void GeometryPool::Free(const GeometryMesh& mesh)
+{
+	CHECK(mesh.IsValid());
+
+	ReturnRange(&FreeVertices, mesh.BaseVertex, mesh.VertexCount);
+	ReturnRange(&FreeIndices, mesh.FirstIndex, mesh.IndexCount);
+}
+
+SubBuffer GeometryPool::Stage(const void* data, usize size)
+{
+	// Each frame in flight has its own slice of staging memory, which is free again once that frame's fence is passed.
+	// The frame count rather than the index decides when to start over, as the index repeats for a pool that skips
+	// frames and never changes with a single frame in flight.
+	const uint64 frame = Device->GetFrameCount();
+	if (frame != StagingFrame)
+	{
+		StagingFrame = frame;
+		StagingHead = 0;
+	}
+
+	VERIFY(StagingHead + size <= StagingSize, "Geometry pool staging is too small for one frame of uploads!");
+
+	const SubBuffer staging =
+	{
+		.Resource = StagingResource,
+		.Size = size,
+		.Stride = 0,
+		.Offset = Device->GetFrameIndex() * StagingSize + StagingHead,
+	};
+	Device->Write(staging, data);
+
+	StagingHead += size;
+	return staging;
+}
+
+void GeometryPool::Upload(const GraphicsContext& context, const GeometryMesh& mesh, const void* vertices, const void* indices)
+{
+	CHECK(mesh.IsValid());
+
+	const SubBuffer vertexDestination =
+	{
+		.Resource = VertexResource,
+		.Size = mesh.VertexCount * VertexStride,
+		.Stride = VertexStride,
+		.Offset = mesh.BaseVertex * VertexStride,
+	};
+	context.Copy(vertexDestination, Stage(vertices, vertexDestination.Size));
+
+	const SubBuffer indexDestination =
+	{
+		.Resource = IndexResource,
+		.Size = mesh.IndexCount * IndexStride,
+		.Stride = IndexStride,
+		.Offset = mesh.FirstIndex * IndexStride,
+	};
+	context.Copy(indexDestination, Stage(indices, indexDestination.Size));
+}
+
+SubBuffer GeometryPool::GetVertexBuffer() const
+{
+	return SubBuffer
+	{
+		.Resource = VertexResource,
+		.Size = VertexStride * VertexCapacity,
+		.Stride = VertexStride,
+		.Offset = 0,
+	};
+}
+
+SubBuffer GeometryPool::GetIndexBuffer() const
+{
+	return SubBuffer
+	{
+		.Resource = IndexResource,
+		.Size = IndexStride * IndexCapacity,
+		.Stride = IndexStride,
+		.Offset = 0,
+	};
+}
+
+usize GeometryPool::GetFreeVertexCount() const
+{
+	return CountFree(FreeVertices);
+}
+
+usize GeometryPool::GetFreeIndexCount() const
+{
+	return CountFree(FreeIndices);
+}
+
+}
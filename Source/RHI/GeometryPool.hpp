@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include "Forward.hpp"
+#include "Resource.hpp"
+
+#include "Luft/Array.hpp"
+#include "Luft/NoCopy.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI
+{
+
+struct GeometryPoolDescription
+{
+	// Every mesh in a pool shares one interleaved vertex layout and one index size of two or four bytes.
+	usize VertexStride;
+	usize IndexStride;
+
+	usize VertexCapacity;
+	usize IndexCapacity;
+
+	// Upload memory for one frame of Upload calls. The pool keeps this much for each frame in flight.
+	usize StagingSize;
+
+	StringView Name;
+};
+
+// Draw with GraphicsContext::DrawIndexed(IndexCount, FirstIndex, BaseVertex) while the pool's buffers are bound.
+struct GeometryMesh
+{
+	uint32 BaseVertex;
+	uint32 VertexCount;
+	uint32 FirstIndex;
+	uint32 IndexCount;
+
+	bool IsValid() const { return VertexCount != 0; }
+};
+
+// Sub-allocates meshes from one vertex buffer and one index buffer, so a pass binds them once and only changes the
+// ranges it draws. Ranges are handed out first fit and merged with their neighbours when freed. Like Destroy, Free must
+// not be called while the GPU may still read the mesh.
+class GeometryPool final : public GeometryPoolDescription, NoCopy
+{
+public:
+	GeometryPool(const GeometryPoolDescription& description, const Device* device);
+	~GeometryPool();
+
+	// Returns an invalid mesh when either buffer has no free range large enough.
+	GeometryMesh Allocate(usize vertexCount, usize indexCount);
+	void Free(const GeometryMesh& mesh);
+
+	// Stages the mesh data and records the copies into its ranges. Before drawing, barrier both buffers from Copy and
+	// CopyDestination to the vertex and index buffer stages, once for all the uploads of a frame. The context must be
+	// submitted in the frame it was recorded, as staging memory is reused once that frame's slot comes around again.
+	void Upload(const GraphicsContext& context, const GeometryMesh& mesh, const void* vertices, const void* indices);
+
+	SubBuffer GetVertexBuffer() const;
+	SubBuffer GetIndexBuffer() const;
+
+	const Resource& GetVertexResource() const { return VertexResource; }
+	const Resource& GetIndexResource() const { return IndexResource; }
+
+	usize GetFreeVertexCount() const;
+	usize GetFreeIndexCount() const;
+
+private:
+	// Offsets and counts are in vertices or indices. Ranges emptied by a merge stay in the array for reuse.
+	struct Range
+	{
+		usize Offset;
+		usize Count;
+	};
+
+	static bool TakeRange(Array<Range>* ranges, usize count, usize* offset);
+	static void ReturnRange(Array<Range>* ranges, usize offset, usize count);
+	static usize CountFree(const Array<Range>& ranges);
+
+	SubBuffer Stage(const void* data, usize size);
+
+	const Device* Device;
+
+	Resource VertexResource;
+	Resource IndexResource;
+	Resource StagingResource;
+
+	Array<Range> FreeVertices;
+	Array<Range> FreeIndices;
+
+	uint64 StagingFrame;
+	usize StagingHead;
+};
+
+}
@@ -1,6 +1,9 @@
 #include "GraphicsContext.hpp"
+#include "BufferView.hpp"
 #include "ComputePipeline.hpp"
 #include "GraphicsPipeline.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 #include "TextureView.hpp"
 
 #include "D3D12/Base.hpp"
@@ -61,6 +64,21 @@ void GraphicsContext::ClearDepthStencil(const TextureView& depthStencil) const
 	Backend->ClearDepthStencil(depthStencil.Backend);
 }
 
+void GraphicsContext::ClearUnorderedAccess(const BufferView& buffer, uint32 value) const
+{
+	Backend->ClearUnorderedAccess(buffer.Backend, value);
+}
+
+void GraphicsContext::ClearUnorderedAccess(const TextureView& texture, const Float4& value) const
+{
+	Backend->ClearUnorderedAccess(texture.Backend, value);
+}
+
+void GraphicsContext::ClearUnorderedAccess(const TextureView& texture, uint32 value) const
+{
+	Backend->ClearUnorderedAccess(texture.Backend, value);
+}
+
 void GraphicsContext::SetPipeline(const GraphicsPipeline& pipeline)
 {
 	Backend->SetPipeline(pipeline.Backend);
@@ -76,6 +94,11 @@ void GraphicsContext::SetVertexBuffer(usize slot, const SubBuffer& vertexBuffer)
 	Backend->SetVertexBuffer(slot, vertexBuffer);
 }
 
+void GraphicsContext::SetVertexBuffers(usize startSlot, const ArrayView<const SubBuffer>& vertexBuffers) const
+{
+	Backend->SetVertexBuffers(startSlot, vertexBuffers);
+}
+
 void GraphicsContext::SetIndexBuffer(const SubBuffer& indexBuffer) const
 {
 	Backend->SetIndexBuffer(indexBuffer);
@@ -86,6 +109,16 @@ void GraphicsContext::SetConstantBuffer(StringView name, const Resource& buffer,
 	Backend->SetConstantBuffer(name, buffer.Backend, offset);
 }
 
+void GraphicsContext::SetShaderResource(StringView name, const Resource& buffer, usize offset) const
+{
+	Backend->SetShaderResource(name, buffer.Backend, offset);
+}
+
+void GraphicsContext::SetUnorderedAccess(StringView name, const Resource& buffer, usize offset) const
+{
+	Backend->SetUnorderedAccess(name, buffer.Backend, offset);
+}
+
 void GraphicsContext::SetRootConstants(const void* data) const
 {
 	Backend->SetRootConstants(data);
@@ -96,9 +129,9 @@ void GraphicsContext::Draw(usize vertexCount) const
 	Backend->Draw(vertexCount);
 }
 
-void GraphicsContext::DrawIndexed(usize indexCount) const
+void GraphicsContext::DrawIndexed(usize indexCount, usize firstIndex, int32 baseVertex) const
 {
-	Backend->DrawIndexed(indexCount);
+	Backend->DrawIndexed(indexCount, firstIndex, baseVertex);
 }
 
 void GraphicsContext::Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ) const
@@ -111,6 +144,70 @@ void GraphicsContext::Copy(const Resource& destination, const Resource& source)
 	Backend->Copy(destination.Backend, source.Backend);
 }
 
+void GraphicsContext::Copy(const SubBuffer& destination, const SubBuffer& source) const
+{
+	CHECK(destination.Size == source.Size);
+	Backend->CopyBufferRegion(destination.Resource.Backend,
+							  destination.Offset,
+							  source.Resource.Backend,
+							  source.Offset,
+							  source.Size);
+}
+
+void GraphicsContext::CopyBufferRegion(const Resource& destination,
+									   usize destinationOffset,
+									   const Resource& source,
+									   usize sourceOffset,
+									   usize size) const
+{
+	Backend->CopyBufferRegion(destination.Backend, destinationOffset, source.Backend, sourceOffset, size);
+}
+
+void GraphicsContext::CopyTextureRegion(const Resource& destination,
+										uint32 destinationMipLevel,
+										uint32 destinationX,
+										uint32 destinationY,
+										const Resource& source,
+										const TextureRegion& sourceRegion) const
+{
+	Backend->CopyTextureRegion(destination.Backend, destinationMipLevel, destinationX, destinationY, source.Backend, sourceRegion);
+}
+
+ReadbackTicket GraphicsContext::EnqueueReadback(const ReadbackRing& readbackRing, const SubBuffer& source) const
+{
+	return Backend->EnqueueReadback(readbackRing.Backend, source);
+}
+
+ReadbackTicket GraphicsContext::EnqueueReadback(const ReadbackRing& readbackRing, const Resource& texture, uint32 mipLevel) const
+{
+	return Backend->EnqueueReadback(readbackRing.Backend, texture.Backend, mipLevel);
+}
+
+void GraphicsContext::BeginQuery(const QueryPool& queryPool, usize index) const
+{
+	Backend->BeginQuery(queryPool.Backend, index);
+}
+
+void GraphicsContext::EndQuery(const QueryPool& queryPool, usize index) const
+{
+	Backend->EndQuery(queryPool.Backend, index);
+}
+
+void GraphicsContext::ResolveQueryData(const QueryPool& queryPool, usize firstIndex, usize count, const Resource& destination, usize offset) const
+{
+	Backend->ResolveQueryData(queryPool.Backend, firstIndex, count, destination.Backend, offset);
+}
+
+void GraphicsContext::SetPredication(const Resource& buffer, usize offset, PredicationOperation operation) const
+{
+	Backend->SetPredication(buffer.Backend, offset, operation);
+}
+
+void GraphicsContext::ClearPredication() const
+{
+	Backend->ClearPredication();
+}
+
 void GraphicsContext::GlobalBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access) const
 {
 	Backend->GlobalBarrier(stage, access);
@@ -124,9 +221,38 @@ void GraphicsContext::BufferBarrier(BarrierPair<BarrierStage> stage, BarrierPair
 void GraphicsContext::TextureBarrier(BarrierPair<BarrierStage> stage,
 									 BarrierPair<BarrierAccess> access,
 									 BarrierPair<BarrierLayout> layout,
-									 const Resource& texture) const
+									 const Resource& texture,
+									 const BarrierSubresourceRange& subresources) const
+{
+	Backend->TextureBarrier(stage, access, layout, texture.Backend, subresources);
+}
+
+void GraphicsContext::BeginBufferBarrier(BarrierStage stageBefore, BarrierPair<BarrierAccess> access, const Resource& buffer) const
+{
+	Backend->BeginBufferBarrier(stageBefore, access, buffer.Backend);
+}
+
+void GraphicsContext::EndBufferBarrier(BarrierStage stageAfter, BarrierPair<BarrierAccess> access, const Resource& buffer) const
+{
+	Backend->EndBufferBarrier(stageAfter, access, buffer.Backend);
+}
+
+void GraphicsContext::BeginTextureBarrier(BarrierStage stageBefore,
+										  BarrierPair<BarrierAccess> access,
+										  BarrierPair<BarrierLayout> layout,
+										  const Resource& texture,
+										  const BarrierSubresourceRange& subresources) const
+{
+	Backend->BeginTextureBarrier(stageBefore, access, layout, texture.Backend, subresources);
+}
+
+void GraphicsContext::EndTextureBarrier(BarrierStage stageAfter,
+										BarrierPair<BarrierAccess> access,
+										BarrierPair<BarrierLayout> layout,
+										const Resource& texture,
+										const BarrierSubresourceRange& subresources) const
 {
-	Backend->TextureBarrier(stage, access, layout, texture.Backend);
+	Backend->EndTextureBarrier(stageAfter, access, layout, texture.Backend, subresources);
 }
 
 void GraphicsContext::BuildAccelerationStructure(const AccelerationStructureGeometry& geometry,
@@ -3,6 +3,8 @@
 #include "Barrier.hpp"
 #include "Forward.hpp"
 #include "HLSL.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 
 #include "Luft/Array.hpp"
 #include "Luft/String.hpp"
@@ -52,27 +54,86 @@ public:
 	void ClearRenderTarget(const TextureView& renderTarget) const;
 	void ClearDepthStencil(const TextureView& depthStencil) const;
 
+	// Buffer views are raw, so they are filled with a 32-bit value. Texture views take floats for float, UNorm and SNorm
+	// formats and a value written to every channel for integer formats. The views must be UnorderedAccess views.
+	void ClearUnorderedAccess(const BufferView& buffer, uint32 value) const;
+	void ClearUnorderedAccess(const TextureView& texture, const Float4& value) const;
+	void ClearUnorderedAccess(const TextureView& texture, uint32 value) const;
+
 	void SetPipeline(const GraphicsPipeline& pipeline);
 	void SetPipeline(const ComputePipeline& pipeline);
 
 	void SetVertexBuffer(usize slot, const SubBuffer& vertexBuffer) const;
+
+	// Bind one buffer per stream to consecutive slots, as laid out by the pipeline's vertex attributes.
+	void SetVertexBuffers(usize startSlot, const ArrayView<const SubBuffer>& vertexBuffers) const;
+
 	void SetIndexBuffer(const SubBuffer& indexBuffer) const;
 
 	void SetConstantBuffer(StringView name, const Resource& buffer, usize offset = 0) const;
+
+	// Bind a StructuredBuffer or ByteAddressBuffer, or their RW forms, directly in the root signature. The offset must
+	// be a multiple of four bytes.
+	void SetShaderResource(StringView name, const Resource& buffer, usize offset = 0) const;
+	void SetUnorderedAccess(StringView name, const Resource& buffer, usize offset = 0) const;
+
 	void SetRootConstants(const void* data) const;
 
 	void Draw(usize vertexCount) const;
-	void DrawIndexed(usize indexCount) const;
+	// The base vertex is added to every index, so meshes sharing one vertex buffer keep indices relative to their own
+	// first vertex.
+	void DrawIndexed(usize indexCount, usize firstIndex = 0, int32 baseVertex = 0) const;
 	void Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ) const;
 
 	void Copy(const Resource& destination, const Resource& source) const;
+	void Copy(const SubBuffer& destination, const SubBuffer& source) const;
+	void CopyBufferRegion(const Resource& destination,
+						  usize destinationOffset,
+						  const Resource& source,
+						  usize sourceOffset,
+						  usize size) const;
+	void CopyTextureRegion(const Resource& destination,
+						   uint32 destinationMipLevel,
+						   uint32 destinationX,
+						   uint32 destinationY,
+						   const Resource& source,
+						   const TextureRegion& sourceRegion) const;
+
+	ReadbackTicket EnqueueReadback(const ReadbackRing& readbackRing, const SubBuffer& source) const;
+	ReadbackTicket EnqueueReadback(const ReadbackRing& readbackRing, const Resource& texture, uint32 mipLevel = 0) const;
+
+	void BeginQuery(const QueryPool& queryPool, usize index) const;
+	void EndQuery(const QueryPool& queryPool, usize index) const;
+	void ResolveQueryData(const QueryPool& queryPool, usize firstIndex, usize count, const Resource& destination, usize offset = 0) const;
+
+	void SetPredication(const Resource& buffer, usize offset, PredicationOperation operation) const;
+	void ClearPredication() const;
 
 	void GlobalBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access) const;
 	void BufferBarrier(BarrierPair<BarrierStage> stage, BarrierPair<BarrierAccess> access, const Resource& buffer) const;
+
+	// Transitioning only the mips a pass touches lets a downsample chain read mip N - 1 while writing mip N.
 	void TextureBarrier(BarrierPair<BarrierStage> stage,
 						BarrierPair<BarrierAccess> access,
 						BarrierPair<BarrierLayout> layout,
-						const Resource& texture) const;
+						const Resource& texture,
+						const BarrierSubresourceRange& subresources = {}) const;
+
+	// Split barriers. Begin after the last use of a resource and End before its next one, so the transition overlaps
+	// the work recorded in between instead of stalling at either point. Both halves take the same access, layout and
+	// subresources, and must be recorded on the same context between Begin and End.
+	void BeginBufferBarrier(BarrierStage stageBefore, BarrierPair<BarrierAccess> access, const Resource& buffer) const;
+	void EndBufferBarrier(BarrierStage stageAfter, BarrierPair<BarrierAccess> access, const Resource& buffer) const;
+	void BeginTextureBarrier(BarrierStage stageBefore,
+							 BarrierPair<BarrierAccess> access,
+							 BarrierPair<BarrierLayout> layout,
+							 const Resource& texture,
+							 const BarrierSubresourceRange& subresources = {}) const;
+	void EndTextureBarrier(BarrierStage stageAfter,
+						   BarrierPair<BarrierAccess> access,
+						   BarrierPair<BarrierLayout> layout,
+						   const Resource& texture,
+						   const BarrierSubresourceRange& subresources = {}) const;
 
 	void BuildAccelerationStructure(const AccelerationStructureGeometry& geometry,
 									const Resource& scratchResource,
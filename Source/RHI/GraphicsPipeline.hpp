@@ -23,6 +23,139 @@ public:
 		CHECK(!Contains(shader.Stage));
 		Add(shader.Stage, shader);
 	}
+
+	const RHI_BACKEND(Shader)* GetBackend(ShaderStage stage) const
+	{
+		for (const auto& [key, shader] : *this)
+		{
+			if (key == stage)
+			{
+				return shader.Backend;
+			}
+		}
+		return nullptr;
+	}
+};
+
+// Order in which pipelines created with Device::CreateAsync are built. Pipelines of equal priority build in the order
+// they were created.
+enum class PipelinePriority : uint8
+{
+	Low,
+	Normal,
+	High,
+};
+
+// The first value of every fixed-function state enum is what pipelines used before the state could be chosen, so
+// descriptions that leave it zeroed keep building the same pipeline.
+enum class CullMode : uint8
+{
+	Back,
+	Front,
+	None,
+};
+
+// Default tests LessEqual, or GreaterEqual with ReverseDepth.
+enum class ComparisonFunction : uint8
+{
+	Default,
+	Never,
+	Less,
+	Equal,
+	LessEqual,
+	Greater,
+	NotEqual,
+	GreaterEqual,
+	Always,
+};
+
+// Default blends by alpha when the pipeline has AlphaBlend set and is opaque otherwise.
+enum class BlendMode : uint8
+{
+	Default,
+	Opaque,
+	Alpha,
+	Additive,
+	Premultiplied,
+};
+
+enum class ColorWrite : uint8
+{
+	All,
+	Color,
+	Alpha,
+	None,
+};
+
+enum class PrimitiveTopology : uint8
+{
+	TriangleList,
+	TriangleStrip,
+	LineList,
+	LineStrip,
+	PointList,
+};
+
+struct RenderTargetBlend
+{
+	BlendMode Blend;
+	ColorWrite Write;
+};
+
+struct DepthBias
+{
+	int32 Constant;
+	float SlopeScaled;
+	float Clamp;
+};
+
+// How a vertex input is stored in its vertex buffer. Normalized formats arrive in the shader as floats in [0, 1] or
+// [-1, 1], so a float3 position can be fed from SNorm16x4 with the mesh bounds applied in the shader.
+enum class VertexFormat : uint8
+{
+	Inferred,
+
+	Float32,
+	Float32x2,
+	Float32x3,
+	Float32x4,
+
+	Float16x2,
+	Float16x4,
+
+	SNorm16x2,
+	SNorm16x4,
+	UNorm16x2,
+	UNorm16x4,
+
+	SNorm8x4,
+	UNorm8x4,
+	UNorm10x3A2,
+
+	UInt8x4,
+	UInt16x2,
+	UInt16x4,
+	UInt32,
+	UInt32x2,
+	UInt32x3,
+	UInt32x4,
+};
+
+// Places the input directly after the previous one in its stream.
+inline constexpr uint32 VertexOffsetAppend = UINT32_MAX;
+
+// A placed attribute reads its input from Stream, the vertex buffer slot, at Offset bytes into each vertex. Other inputs,
+// including those whose attribute only sets Format, keep reading from the slot matching their input register, directly
+// after the previous input there. Splitting positions into a stream of their own lets depth and shadow passes bind only
+// that stream.
+struct VertexAttribute
+{
+	StringView Semantic;
+	uint32 SemanticIndex;
+	VertexFormat Format;
+	bool Placed;
+	uint32 Stream;
+	uint32 Offset;
 };
 
 struct GraphicsPipelineDescription
@@ -35,7 +168,75 @@ struct GraphicsPipelineDescription
 	bool AlphaBlend;
 	bool ReverseDepth;
 
+	// Either empty, or one for each render target format.
+	ArrayView<const RenderTargetBlend> RenderTargetBlends;
+
+	// Overrides for the vertex shader inputs they name. Other inputs are stored as their HLSL type, so half and int16_t
+	// inputs read 16-bit data without an override.
+	ArrayView<const VertexAttribute> VertexAttributes;
+
+	CullMode CullMode;
+	ComparisonFunction DepthFunction;
+	bool DisableDepthWrite;
+	DepthBias DepthBias;
+	PrimitiveTopology PrimitiveTopology;
+
 	StringView Name;
+
+	// Pipelines built from the same shaders and state are the same pipeline, whatever they were named.
+	bool operator==(const GraphicsPipelineDescription& other) const
+	{
+		if (Stages.GetCount() != other.Stages.GetCount() ||
+			RenderTargetFormats.GetLength() != other.RenderTargetFormats.GetLength() ||
+			RenderTargetBlends.GetLength() != other.RenderTargetBlends.GetLength() ||
+			VertexAttributes.GetLength() != other.VertexAttributes.GetLength() ||
+			DepthStencilFormat != other.DepthStencilFormat || AlphaBlend != other.AlphaBlend ||
+			ReverseDepth != other.ReverseDepth || CullMode != other.CullMode || DepthFunction != other.DepthFunction ||
+			DisableDepthWrite != other.DisableDepthWrite || PrimitiveTopology != other.PrimitiveTopology ||
+			DepthBias.Constant != other.DepthBias.Constant || DepthBias.SlopeScaled != other.DepthBias.SlopeScaled ||
+			DepthBias.Clamp != other.DepthBias.Clamp)
+		{
+			return false;
+		}
+		for (const auto& [stage, shader] : Stages)
+		{
+			if (other.Stages.GetBackend(stage) != shader.Backend)
+			{
+				return false;
+			}
+		}
+		for (usize i = 0; i < RenderTargetFormats.GetLength(); ++i)
+		{
+			if (RenderTargetFormats[i] != other.RenderTargetFormats[i])
+			{
+				return false;
+			}
+		}
+		for (usize i = 0; i < RenderTargetBlends.GetLength(); ++i)
+		{
+			if (RenderTargetBlends[i].Blend != other.RenderTargetBlends[i].Blend ||
+				RenderTargetBlends[i].Write != other.RenderTargetBlends[i].Write)
+			{
+				return false;
+			}
+		}
+		for (usize i = 0; i < VertexAttributes.GetLength(); ++i)
+		{
+			if (VertexAttributes[i].Semantic != other.VertexAttributes[i].Semantic ||
+				VertexAttributes[i].SemanticIndex != other.VertexAttributes[i].SemanticIndex ||
+				VertexAttributes[i].Format != other.VertexAttributes[i].Format ||
+				VertexAttributes[i].Placed != other.VertexAttributes[i].Placed)
+			{
+				return false;
+			}
+			if (VertexAttributes[i].Placed && (VertexAttributes[i].Stream != other.VertexAttributes[i].Stream ||
+											   VertexAttributes[i].Offset != other.VertexAttributes[i].Offset))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
 };
 
 class GraphicsPipeline final : public GraphicsPipelineDescription
@@ -60,3 +261,52 @@ public:
 };
 
 }
+
+template<>
+struct Hash<RHI::GraphicsPipelineDescription>
+{
+	uint64 operator()(const RHI::GraphicsPipelineDescription& key) const
+	{
+		// Formats, blends and streams are a byte each, so every render target fits in one value. The depth bias floats
+		// and the vertex attribute semantics and offsets are left to the equality check.
+		uint64 renderTargetFormats = 0;
+		for (usize i = 0; i < key.RenderTargetFormats.GetLength() && i < sizeof(uint64); ++i)
+		{
+			renderTargetFormats |= static_cast<uint64>(key.RenderTargetFormats[i]) << (i * 8);
+		}
+		uint64 vertexFormats = 0;
+		uint64 vertexStreams = 0;
+		for (usize i = 0; i < key.VertexAttributes.GetLength() && i < sizeof(uint64); ++i)
+		{
+			vertexFormats |= static_cast<uint64>(key.VertexAttributes[i].Format) << (i * 8);
+			const RHI::VertexAttribute& attribute = key.VertexAttributes[i];
+			vertexStreams |= (attribute.Placed ? static_cast<uint64>((attribute.Stream & 0x7F) | 0x80) : 0) << (i * 8);
+		}
+		uint64 renderTargetBlends = 0;
+		for (usize i = 0; i < key.RenderTargetBlends.GetLength() && i < sizeof(uint64); ++i)
+		{
+			const RHI::RenderTargetBlend& blend = key.RenderTargetBlends[i];
+			renderTargetBlends |= (static_cast<uint64>(blend.Blend) | (static_cast<uint64>(blend.Write) << 4)) << (i * 8);
+		}
+
+		const uint64 values[] =
+		{
+			reinterpret_cast<uintptr_t>(key.Stages.GetBackend(RHI::ShaderStage::Vertex)),
+			reinterpret_cast<uintptr_t>(key.Stages.GetBackend(RHI::ShaderStage::Pixel)),
+			renderTargetFormats,
+			static_cast<uint64>(key.RenderTargetFormats.GetLength()),
+			static_cast<uint64>(key.DepthStencilFormat),
+			renderTargetBlends,
+			static_cast<uint64>(key.RenderTargetBlends.GetLength()),
+			vertexFormats,
+			vertexStreams,
+			static_cast<uint64>(key.VertexAttributes.GetLength()),
+			static_cast<uint64>(key.AlphaBlend) | (static_cast<uint64>(key.ReverseDepth) << 1) |
+				(static_cast<uint64>(key.DisableDepthWrite) << 2),
+			static_cast<uint64>(key.CullMode) | (static_cast<uint64>(key.DepthFunction) << 8) |
+				(static_cast<uint64>(key.PrimitiveTopology) << 16),
+			static_cast<uint64>(static_cast<uint32>(key.DepthBias.Constant)),
+		};
+		return HashFnv1a(values, sizeof(values));
+	}
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Forward.hpp"
+
+#include "Luft/Base.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI
+{
+
+enum class QueryType : uint8
+{
+	Occlusion,
+	BinaryOcclusion,
+};
+
+enum class PredicationOperation : uint8
+{
+	EqualZero,
+	NotEqualZero,
+};
+
+inline constexpr usize QueryResultSize = sizeof(uint64);
+
+struct QueryPoolDescription
+{
+	QueryType Type;
+	usize Count;
+
+	StringView Name;
+};
+
+class QueryPool final : public QueryPoolDescription
+{
+public:
+	QueryPool()
+		: QueryPoolDescription()
+		, Backend(nullptr)
+	{
+	}
+
+	QueryPool(const QueryPoolDescription& description, RHI_BACKEND(QueryPool)* backend)
+		: QueryPoolDescription(description)
+		, Backend(backend)
+	{
+	}
+
+	static QueryPool Invalid() { return {}; }
+	bool IsValid() const { return Backend != nullptr; }
+
+	RHI_BACKEND(QueryPool)* Backend;
+};
+
+}
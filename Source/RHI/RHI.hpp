@@ -7,7 +7,14 @@
 #include "BufferView.hpp"
 #include "ComputePipeline.hpp"
 #include "Device.hpp"
+#include "Fence.hpp"
+#include "GeometryPool.hpp"
 #include "GraphicsContext.hpp"
 #include "GraphicsPipeline.hpp"
+#include "QueryPool.hpp"
+#include "ReadbackRing.hpp"
 #include "Resource.hpp"
+#include "ShaderLibrary.hpp"
+#include "ShaderReflection.hpp"
 #include "TextureView.hpp"
+#include "VertexPacking.hpp"
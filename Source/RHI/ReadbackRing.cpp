@@ -0,0 +1,28 @@
+#include "ReadbackRing.hpp"
+
+#include "D3D12/ReadbackRing.hpp"
+
+namespace RHI
+{
+
+bool ReadbackRing::IsReady(const ReadbackTicket& ticket) const
+{
+	return Backend->IsReady(ticket);
+}
+
+void ReadbackRing::Wait(const ReadbackTicket& ticket) const
+{
+	Backend->Wait(ticket);
+}
+
+const void* ReadbackRing::GetData(const ReadbackTicket& ticket) const
+{
+	return Backend->GetData(ticket);
+}
+
+void ReadbackRing::Read(const ReadbackTicket& ticket, void* data) const
+{
+	Backend->Read(ticket, data);
+}
+
+}
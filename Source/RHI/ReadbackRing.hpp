@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Forward.hpp"
+
+#include "Luft/Base.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI
+{
+
+struct ReadbackTicket
+{
+	usize Offset;
+	usize Size;
+	uint64 FenceValue;
+
+	uint32 RowPitch;
+	uint32 RowSize;
+	uint32 RowCount;
+};
+
+struct ReadbackRingDescription
+{
+	usize Size;
+
+	StringView Name;
+};
+
+class ReadbackRing final : public ReadbackRingDescription
+{
+public:
+	ReadbackRing()
+		: ReadbackRingDescription()
+		, Backend(nullptr)
+	{
+	}
+
+	ReadbackRing(const ReadbackRingDescription& description, RHI_BACKEND(ReadbackRing)* backend)
+		: ReadbackRingDescription(description)
+		, Backend(backend)
+	{
+	}
+
+	static ReadbackRing Invalid() { return {}; }
+	bool IsValid() const { return Backend != nullptr; }
+
+	bool IsReady(const ReadbackTicket& ticket) const;
+	void Wait(const ReadbackTicket& ticket) const;
+
+	// The mapped data keeps the GPU row pitch. It stays valid until the ring wraps back over the ticket.
+	const void* GetData(const ReadbackTicket& ticket) const;
+	// Copies the data out with rows tightly packed, so RowSize * RowCount bytes are written.
+	void Read(const ReadbackTicket& ticket, void* data) const;
+
+	RHI_BACKEND(ReadbackRing)* Backend;
+};
+
+}
@@ -66,6 +66,16 @@ struct ResourceDimensions
 	uint32 Height;
 };
 
+// A rectangle of one mip level, in texels. Block compressed formats need it aligned to whole blocks.
+struct TextureRegion
+{
+	uint32 MipLevel;
+	uint32 X;
+	uint32 Y;
+	uint32 Width;
+	uint32 Height;
+};
+
 struct ResourceDescription
 {
 	ResourceType Type;
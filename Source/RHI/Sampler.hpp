@@ -3,6 +3,8 @@
 #include "Forward.hpp"
 #include "HLSL.hpp"
 
+#include "Luft/Hash.hpp"
+
 namespace RHI
 {
 
@@ -28,6 +30,14 @@ struct SamplerDescription
 	SamplerAddress HorizontalAddress;
 	SamplerAddress VerticalAddress;
 	Float4 BorderColor;
+
+	bool operator==(const SamplerDescription& other) const
+	{
+		return MinificationFilter == other.MinificationFilter && MagnificationFilter == other.MagnificationFilter &&
+			   HorizontalAddress == other.HorizontalAddress && VerticalAddress == other.VerticalAddress &&
+			   BorderColor.X == other.BorderColor.X && BorderColor.Y == other.BorderColor.Y &&
+			   BorderColor.Z == other.BorderColor.Z && BorderColor.W == other.BorderColor.W;
+	}
 };
 
 class Sampler final : public SamplerDescription
@@ -52,3 +62,12 @@ public:
 };
 
 }
+
+template<>
+struct Hash<RHI::SamplerDescription>
+{
+	uint64 operator()(const RHI::SamplerDescription& key) const
+	{
+		return HashFnv1a(&key, sizeof(key));
+	}
+};
@@ -21,6 +21,26 @@ struct ShaderDefine
 	StringView Value;
 };
 
+struct ShaderCacheStatistics
+{
+	usize Hits;
+	usize Misses;
+
+	usize BytesRead;
+	usize BytesWritten;
+	usize BytesEvicted;
+};
+
+struct ShaderArchiveStatistics
+{
+	usize EntryCount;
+	double LoadTime;
+
+	usize Lookups;
+	usize Hits;
+	double LookupTime;
+};
+
 struct ShaderDescription
 {
 	StringView FilePath;
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Luft/Base.hpp"
+
+// Shared between the runtime and the offline ShaderArchiver, so this header only depends on basic types.
+//
+// Layout: ShaderArchiveHeader, then EntryCount ShaderArchiveEntry records sorted by Key, then the DXIL blob and
+// RHI::ShaderReflection of each entry, each starting on a ShaderArchiveAlignment boundary. All offsets are from the
+// start of the archive.
+
+namespace RHI
+{
+
+inline constexpr uint32 ShaderArchiveMagic = 0x41535248;
+inline constexpr uint32 ShaderArchiveVersion = 4;
+inline constexpr usize ShaderArchiveAlignment = 16;
+
+struct ShaderArchiveHeader
+{
+	uint32 Magic;
+	uint32 Version;
+	uint64 EntryCount;
+};
+
+struct ShaderArchiveEntry
+{
+	uint64 Key;
+	uint64 BlobOffset;
+	uint64 BlobSize;
+	uint64 ReflectionOffset;
+	uint64 ReflectionSize;
+};
+
+inline constexpr uint64 ShaderArchiveHashBasis = 0xCBF29CE484222325;
+inline constexpr uint64 ShaderArchiveHashPrime = 0x00000100000001B3;
+
+inline uint64 HashShaderArchiveBytes(uint64 hash, const char* data, usize length)
+{
+	for (usize i = 0; i < length; ++i)
+	{
+		// Path separators are folded so manifests written on either platform produce the same keys.
+		const char character = data[i] == '\\' ? '/' : data[i];
+		hash ^= static_cast<uint8>(character);
+		hash *= ShaderArchiveHashPrime;
+	}
+	return hash;
+}
+
+inline uint64 HashShaderArchiveDefine(const char* name, usize nameLength, const char* value, usize valueLength)
+{
+	uint64 hash = HashShaderArchiveBytes(ShaderArchiveHashBasis, name, nameLength);
+	hash = HashShaderArchiveBytes(hash, "=", 1);
+	return HashShaderArchiveBytes(hash, value, valueLength);
+}
+
+// Defines are summed so the key does not depend on the order they were listed in. The stage is the numeric value of
+// RHI::ShaderStage.
+inline uint64 HashShaderArchiveKey(const char* filePath, usize filePathLength, uint8 stage, uint64 defineHashSum)
+{
+	uint64 hash = HashShaderArchiveBytes(ShaderArchiveHashBasis, filePath, filePathLength);
+	hash ^= stage;
+	hash *= ShaderArchiveHashPrime;
+	for (usize i = 0; i < sizeof(defineHashSum); ++i)
+	{
+		hash ^= (defineHashSum >> (i * 8)) & 0xFF;
+		hash *= ShaderArchiveHashPrime;
+	}
+	return hash;
+}
+
+}
@@ -0,0 +1,256 @@
+#include "ShaderLibrary.hpp"
+#include "Allocator.hpp"
+#include "Device.hpp"
+
+namespace RHI
+{
+
+static constexpr usize PermutationBucketCount = 256;
+
+static bool SameAxes(ArrayView<const ShaderAxis> axes, ArrayView<const ShaderAxis> otherAxes)
+{
+	if (axes.GetLength() != otherAxes.GetLength())
+	{
+		return false;
+	}
+	for (usize axisIndex = 0; axisIndex < axes.GetLength(); ++axisIndex)
+	{
+		const ShaderAxis& axis = axes[axisIndex];
+		const ShaderAxis& otherAxis = otherAxes[axisIndex];
+		if (!(axis.Name == otherAxis.Name) || axis.Values.GetLength() != otherAxis.Values.GetLength())
+		{
+			return false;
+		}
+		for (usize i = 0; i < axis.Values.GetLength(); ++i)
+		{
+			if (!(axis.Values[i] == otherAxis.Values[i]))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+ShaderLibrary::ShaderLibrary(const RHI::Device* device)
+	: Device(device)
+	, Declarations(Allocator)
+	, Compiled(PermutationBucketCount, Allocator)
+	, Requested(Allocator)
+{
+}
+
+ShaderLibrary::~ShaderLibrary()
+{
+	for (auto& [_, permutation] : Compiled)
+	{
+		Device->Destroy(&permutation.Shader);
+		Allocator->Destroy(permutation.Defines);
+	}
+}
+
+usize ShaderLibrary::Declare(const ShaderPermutationsDescription& description)
+{
+	VERIFY(description.Axes.GetLength() <= MaxShaderAxes, "Too many shader permutation axes!");
+
+	for (usize permutations = 0; permutations < Declarations.GetLength(); ++permutations)
+	{
+		const ShaderPermutationsDescription& declared = Declarations[permutations].Description;
+		if (declared.FilePath == description.FilePath && declared.Stage == description.Stage)
+		{
+			VERIFY(SameAxes(declared.Axes, description.Axes),
+				   "Shader permutations were declared again with different axes!");
+			return permutations;
+		}
+	}
+
+	uint64 permutationCount = 1;
+	for (const ShaderAxis& axis : description.Axes)
+	{
+		VERIFY(axis.Values.GetLength() > 0, "A shader permutation axis needs at least one value!");
+		permutationCount *= axis.Values.GetLength();
+	}
+
+	Declarations.Add(Declaration
+	{
+		.Description = description,
+		.PermutationCount = permutationCount,
+	});
+	return Declarations.GetLength() - 1;
+}
+
+ShaderPermutationKey ShaderLibrary::Canonicalize(usize permutations, ArrayView<const ShaderDefine> defines) const
+{
+	CHECK(permutations < Declarations.GetLength());
+	const ShaderPermutationsDescription& description = Declarations[permutations].Description;
+
+	uint64 index = 0;
+	uint64 stride = 1;
+	usize knownCount = 0;
+	for (const ShaderAxis& axis : description.Axes)
+	{
+		usize valueIndex = 0;
+		for (const ShaderDefine& define : defines)
+		{
+			if (!(define.Name == axis.Name))
+			{
+				continue;
+			}
+
+			++knownCount;
+			valueIndex = axis.Values.GetLength();
+			for (usize i = 0; i < axis.Values.GetLength(); ++i)
+			{
+				if (axis.Values[i] == define.Value)
+				{
+					valueIndex = i;
+					break;
+				}
+			}
+			VERIFY(valueIndex < axis.Values.GetLength(), "Shader define value is not part of its permutation axis!");
+		}
+
+		index += valueIndex * stride;
+		stride *= axis.Values.GetLength();
+	}
+
+	// Every define named an axis only if each was matched once, as axis names are distinct.
+	VERIFY(knownCount == defines.GetLength(), "Shader define is not a declared permutation axis!");
+
+	return ShaderPermutationKey { permutations, index };
+}
+
+ShaderDescription ShaderLibrary::GetDescription(const ShaderPermutationKey& key, ShaderDefine* defines) const
+{
+	const ShaderPermutationsDescription& description = Declarations[key.Permutations].Description;
+
+	uint64 index = key.Index;
+	for (usize axisIndex = 0; axisIndex < description.Axes.GetLength(); ++axisIndex)
+	{
+		const ShaderAxis& axis = description.Axes[axisIndex];
+		defines[axisIndex] = ShaderDefine
+		{
+			.Name = axis.Name,
+			.Value = axis.Values[index % axis.Values.GetLength()],
+		};
+		index /= axis.Values.GetLength();
+	}
+
+	return ShaderDescription
+	{
+		.FilePath = description.FilePath,
+		.Stage = description.Stage,
+		.Defines = ArrayView<const ShaderDefine>(defines, description.Axes.GetLength()),
+	};
+}
+
+Array<ShaderDefine>* ShaderLibrary::CopyDefines(const ShaderDescription& description) const
+{
+	Array<ShaderDefine>* defines = Allocator->Create<Array<ShaderDefine>>(description.Defines.GetLength(), Allocator);
+	for (const ShaderDefine& define : description.Defines)
+	{
+		defines->Add(define);
+	}
+	return defines;
+}
+
+Shader ShaderLibrary::Get(usize permutations, ArrayView<const ShaderDefine> defines)
+{
+	const ShaderPermutationKey key = Canonicalize(permutations, defines);
+	if (Compiled.Contains(key))
+	{
+		return Compiled[key].Shader;
+	}
+
+	ShaderDefine canonicalDefines[MaxShaderAxes];
+	const ShaderDescription description = GetDescription(key, canonicalDefines);
+
+	// The Shader keeps a view of its defines, so they need storage that lives as long as it does.
+	Array<ShaderDefine>* ownedDefines = CopyDefines(description);
+	const Shader shader = Device->Create(ShaderDescription
+	{
+		.FilePath = description.FilePath,
+		.Stage = description.Stage,
+		.Defines = ArrayView<const ShaderDefine>(ownedDefines->GetData(), ownedDefines->GetLength()),
+	});
+
+	Compiled.Add(key, Permutation
+	{
+		.Shader = shader,
+		.Defines = ownedDefines,
+	});
+	return shader;
+}
+
+void ShaderLibrary::Request(usize permutations, ArrayView<const ShaderDefine> defines)
+{
+	const ShaderPermutationKey key = Canonicalize(permutations, defines);
+	if (Compiled.Contains(key))
+	{
+		return;
+	}
+
+	for (const ShaderPermutationKey& requested : Requested)
+	{
+		if (requested == key)
+		{
+			return;
+		}
+	}
+	Requested.Add(key);
+}
+
+void ShaderLibrary::CompileRequests(Array<String>* errors)
+{
+	if (Requested.GetLength() == 0)
+	{
+		return;
+	}
+
+	Array<ShaderDescription> descriptions(Requested.GetLength(), Allocator);
+	Array<Array<ShaderDefine>*> ownedDefines(Requested.GetLength(), Allocator);
+	for (const ShaderPermutationKey& key : Requested)
+	{
+		ShaderDefine canonicalDefines[MaxShaderAxes];
+		const ShaderDescription description = GetDescription(key, canonicalDefines);
+
+		Array<ShaderDefine>* defines = CopyDefines(description);
+		ownedDefines.Add(defines);
+		descriptions.Add(ShaderDescription
+		{
+			.FilePath = description.FilePath,
+			.Stage = description.Stage,
+			.Defines = ArrayView<const ShaderDefine>(defines->GetData(), defines->GetLength()),
+		});
+	}
+
+	const Array<Shader> shaders = Device->Create(ArrayView<const ShaderDescription>(descriptions.GetData(), descriptions.GetLength()), errors);
+	for (usize i = 0; i < Requested.GetLength(); ++i)
+	{
+		if (!shaders[i].IsValid())
+		{
+			Allocator->Destroy(ownedDefines[i]);
+			continue;
+		}
+
+		Compiled.Add(Requested[i], Permutation
+		{
+			.Shader = shaders[i],
+			.Defines = ownedDefines[i],
+		});
+	}
+
+	Requested = Array<ShaderPermutationKey>(Allocator);
+}
+
+usize ShaderLibrary::GetPermutationCount() const
+{
+	usize permutationCount = 0;
+	for (const Declaration& declaration : Declarations)
+	{
+		permutationCount += declaration.PermutationCount;
+	}
+	return permutationCount;
+}
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Forward.hpp"
+#include "Shader.hpp"
+
+#include "Luft/Array.hpp"
+#include "Luft/HashTable.hpp"
+#include "Luft/NoCopy.hpp"
+#include "Luft/String.hpp"
+
+namespace RHI
+{
+
+inline constexpr usize MaxShaderAxes = 16;
+
+// A define the shader can be permuted over. The first value is used when a request leaves the axis out.
+struct ShaderAxis
+{
+	StringView Name;
+	ArrayView<const StringView> Values;
+};
+
+struct ShaderPermutationsDescription
+{
+	StringView FilePath;
+	ShaderStage Stage;
+	ArrayView<const ShaderAxis> Axes;
+};
+
+struct ShaderPermutationKey
+{
+	usize Permutations;
+	uint64 Index;
+
+	bool operator==(const ShaderPermutationKey& other) const { return Permutations == other.Permutations && Index == other.Index; }
+};
+
+}
+
+template<>
+struct Hash<RHI::ShaderPermutationKey>
+{
+	uint64 operator()(const RHI::ShaderPermutationKey& key) const
+	{
+		return HashFnv1a(&key, sizeof(key));
+	}
+};
+
+namespace RHI
+{
+
+// Compiles shader permutations on first use and hands out one Shader per distinct permutation. Define sets are put
+// into axis order before hashing, so the same defines in a different order resolve to the same Shader. The axis names
+// and values are referenced, not copied, and must outlive the library.
+class ShaderLibrary final : public NoCopy
+{
+public:
+	explicit ShaderLibrary(const Device* device);
+	~ShaderLibrary();
+
+	// Declaring the same file and stage twice returns the first declaration, and the axes must match it.
+	usize Declare(const ShaderPermutationsDescription& description);
+
+	// Compiles the permutation now if it has not been compiled before.
+	Shader Get(usize permutations, ArrayView<const ShaderDefine> defines);
+
+	// Queues the permutation so CompileRequests can build everything queued as one parallel batch.
+	void Request(usize permutations, ArrayView<const ShaderDefine> defines);
+	void CompileRequests(Array<String>* errors);
+
+	usize GetPermutationCount() const;
+	usize GetCompiledCount() const { return Compiled.GetCount(); }
+
+	// Calls function(const ShaderDescription&) for every declared permutation that was never compiled.
+	template<typename Function>
+	void ForEachUnusedPermutation(Function function) const
+	{
+		for (usize permutations = 0; permutations < Declarations.GetLength(); ++permutations)
+		{
+			for (uint64 index = 0; index < Declarations[permutations].PermutationCount; ++index)
+			{
+				if (Compiled.Contains(ShaderPermutationKey { permutations, index }))
+				{
+					continue;
+				}
+
+				ShaderDefine defines[MaxShaderAxes];
+				function(GetDescription(ShaderPermutationKey { permutations, index }, defines));
+			}
+		}
+	}
+
+private:
+	struct Declaration
+	{
+		ShaderPermutationsDescription Description;
+		uint64 PermutationCount;
+	};
+
+	struct Permutation
+	{
+		Shader Shader;
+		Array<ShaderDefine>* Defines;
+	};
+
+	ShaderPermutationKey Canonicalize(usize permutations, ArrayView<const ShaderDefine> defines) const;
+	ShaderDescription GetDescription(const ShaderPermutationKey& key, ShaderDefine* defines) const;
+	Array<ShaderDefine>* CopyDefines(const ShaderDescription& description) const;
+
+	const Device* Device;
+
+	Array<Declaration> Declarations;
+	HashTable<ShaderPermutationKey, Permutation> Compiled;
+	Array<ShaderPermutationKey> Requested;
+};
+
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Luft/Base.hpp"
+
+// A fixed-size, pointer-free summary of what pipelines need from a shader. It is written as-is into the shader cache
+// and shader archives, so changing it requires bumping both of their versions.
+
+namespace RHI
+{
+
+inline constexpr usize MaxReflectedNameLength = 32;
+inline constexpr usize MaxReflectedInputElements = 16;
+inline constexpr usize MaxReflectedBindings = 16;
+
+// Samplers declared in this register space are baked into the root signature instead of read from the sampler heap.
+// The register picks the sampler, so `SamplerState LinearClamp : register(s3, space1);` is always linear and clamped.
+inline constexpr uint32 StaticSamplerSpace = 1;
+
+enum class StaticSampler : uint32
+{
+	PointWrap,
+	PointClamp,
+	LinearWrap,
+	LinearClamp,
+	AnisotropicWrap,
+	AnisotropicClamp,
+};
+
+inline constexpr uint32 StaticSamplerCount = 6;
+
+// Constant buffers and structured or byte address buffers become root descriptors. Samplers are only reflected from
+// the static sampler space, everything else is expected to be indexed from the descriptor heaps.
+enum class ReflectedBindingType : uint32
+{
+	ConstantBuffer,
+	RootConstants,
+	ShaderResource,
+	UnorderedAccess,
+	StaticSampler,
+};
+
+// Shaders compile with 16-bit types enabled, so half, uint16_t and int16_t inputs reflect as such.
+enum class ReflectedComponentType : uint32
+{
+	Float32,
+	Float16,
+	UInt32,
+	SInt32,
+	UInt16,
+	SInt16,
+};
+
+struct ReflectedInputElement
+{
+	char SemanticName[MaxReflectedNameLength];
+	uint32 SemanticIndex;
+	uint32 ComponentMask;
+	ReflectedComponentType ComponentType;
+	uint32 Slot;
+};
+
+struct ReflectedBinding
+{
+	char Name[MaxReflectedNameLength];
+	ReflectedBindingType Type;
+	uint32 Register;
+	uint32 Space;
+	uint32 Size;
+};
+
+struct ShaderReflection
+{
+	uint32 InputElementCount;
+	uint32 BindingCount;
+	uint32 ThreadGroupSize[3];
+	uint32 Reserved;
+
+	ReflectedInputElement InputElements[MaxReflectedInputElements];
+	ReflectedBinding Bindings[MaxReflectedBindings];
+};
+
+}
@@ -4,6 +4,8 @@
 #include "Resource.hpp"
 #include "View.hpp"
 
+#include "Luft/Hash.hpp"
+
 namespace RHI
 {
 
@@ -11,6 +13,18 @@ struct TextureViewDescription
 {
 	ViewType Type;
 	Resource Resource;
+
+	// Shader resource views read MipCount mips from FirstMip, or every mip from there when it is zero. The other view
+	// types write the single mip FirstMip.
+	uint16 FirstMip;
+	uint16 MipCount;
+
+	// Views of the same resource are the same view, whatever the resource was named.
+	bool operator==(const TextureViewDescription& other) const
+	{
+		return Type == other.Type && Resource.Backend == other.Resource.Backend && FirstMip == other.FirstMip &&
+			   MipCount == other.MipCount;
+	}
 };
 
 class TextureView final : public TextureViewDescription
@@ -35,3 +49,18 @@ public:
 };
 
 }
+
+template<>
+struct Hash<RHI::TextureViewDescription>
+{
+	uint64 operator()(const RHI::TextureViewDescription& key) const
+	{
+		const uint64 values[] =
+		{
+			reinterpret_cast<uintptr_t>(key.Resource.Backend),
+			static_cast<uint64>(key.Type),
+			static_cast<uint64>(key.FirstMip) | (static_cast<uint64>(key.MipCount) << 16),
+		};
+		return HashFnv1a(values, sizeof(values));
+	}
+};
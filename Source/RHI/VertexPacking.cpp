@@ -0,0 +1,161 @@
+#include "VertexPacking.hpp"
+
+#include "Luft/Platform.hpp"
+
+#include <immintrin.h>
+
+namespace RHI
+{
+
+static constexpr usize PackBlockLength = 8;
+
+template<typename T>
+using PackBlockFunction = void (*)(__m256 values, T* packed);
+
+// Whole blocks are read straight from the input, and the tail goes through a zeroed block.
+template<typename T>
+static void PackValues(const float* values, usize count, T* packed, PackBlockFunction<T> packBlock)
+{
+	usize i = 0;
+	for (; i + PackBlockLength <= count; i += PackBlockLength)
+	{
+		packBlock(_mm256_loadu_ps(values + i), packed + i);
+	}
+
+	if (i < count)
+	{
+		float tailValues[PackBlockLength] = {};
+		T tailPacked[PackBlockLength] = {};
+		Platform::MemoryCopy(tailValues, values + i, (count - i) * sizeof(float));
+		packBlock(_mm256_loadu_ps(tailValues), tailPacked);
+		Platform::MemoryCopy(packed + i, tailPacked, (count - i) * sizeof(T));
+	}
+}
+
+static __m256i Quantize(__m256 values, float minimum, float scale)
+{
+	const __m256 clamped = _mm256_min_ps(_mm256_max_ps(values, _mm256_set1_ps(minimum)), _mm256_set1_ps(1.0f));
+	return _mm256_cvtps_epi32(_mm256_mul_ps(clamped, _mm256_set1_ps(scale)));
+}
+
+static __m128i PackSigned16(__m256i values)
+{
+	return _mm_packs_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+}
+
+static __m128i PackUnsigned16(__m256i values)
+{
+	return _mm_packus_epi32(_mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+}
+
+static void PackFloat16Block(__m256 values, uint16* packed)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(packed), _mm256_cvtps_ph(values, _MM_FROUND_TO_NEAREST_INT));
+}
+
+static void PackSNorm16Block(__m256 values, int16* packed)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(packed), PackSigned16(Quantize(values, -1.0f, 32767.0f)));
+}
+
+static void PackUNorm16Block(__m256 values, uint16* packed)
+{
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(packed), PackUnsigned16(Quantize(values, 0.0f, 65535.0f)));
+}
+
+static void PackSNorm8Block(__m256 values, int8* packed)
+{
+	const __m128i packed16 = PackSigned16(Quantize(values, -1.0f, 127.0f));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(packed), _mm_packs_epi16(packed16, packed16));
+}
+
+static void PackUNorm8Block(__m256 values, uint8* packed)
+{
+	const __m128i packed16 = PackUnsigned16(Quantize(values, 0.0f, 255.0f));
+	_mm_storel_epi64(reinterpret_cast<__m128i*>(packed), _mm_packus_epi16(packed16, packed16));
+}
+
+void PackFloat16(const float* values, usize count, uint16* packed)
+{
+	PackValues(values, count, packed, PackFloat16Block);
+}
+
+void PackSNorm16(const float* values, usize count, int16* packed)
+{
+	PackValues(values, count, packed, PackSNorm16Block);
+}
+
+void PackUNorm16(const float* values, usize count, uint16* packed)
+{
+	PackValues(values, count, packed, PackUNorm16Block);
+}
+
+void PackSNorm8(const float* values, usize count, int8* packed)
+{
+	PackValues(values, count, packed, PackSNorm8Block);
+}
+
+void PackUNorm8(const float* values, usize count, uint8* packed)
+{
+	PackValues(values, count, packed, PackUNorm8Block);
+}
+
+static __m256 SignNotZero(__m256 values)
+{
+	const __m256 positive = _mm256_cmp_ps(values, _mm256_setzero_ps(), _CMP_GE_OQ);
+	return _mm256_blendv_ps(_mm256_set1_ps(-1.0f), _mm256_set1_ps(1.0f), positive);
+}
+
+static void PackOctahedralBlock(const Float3* normals, int16* packed)
+{
+	const __m256 x = _mm256_setr_ps(normals[0].X, normals[1].X, normals[2].X, normals[3].X,
+									normals[4].X, normals[5].X, normals[6].X, normals[7].X);
+	const __m256 y = _mm256_setr_ps(normals[0].Y, normals[1].Y, normals[2].Y, normals[3].Y,
+									normals[4].Y, normals[5].Y, normals[6].Y, normals[7].Y);
+	const __m256 z = _mm256_setr_ps(normals[0].Z, normals[1].Z, normals[2].Z, normals[3].Z,
+									normals[4].Z, normals[5].Z, normals[6].Z, normals[7].Z);
+
+	const __m256 absoluteMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+	const __m256 inverseLength = _mm256_div_ps(_mm256_set1_ps(1.0f),
+											   _mm256_add_ps(_mm256_add_ps(_mm256_and_ps(x, absoluteMask),
+																		   _mm256_and_ps(y, absoluteMask)),
+															 _mm256_and_ps(z, absoluteMask)));
+	const __m256 octahedronX = _mm256_mul_ps(x, inverseLength);
+	const __m256 octahedronY = _mm256_mul_ps(y, inverseLength);
+
+	// The lower hemisphere folds over the diagonals onto the outer triangles of the square.
+	const __m256 foldedX = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(octahedronY, absoluteMask)),
+										 SignNotZero(octahedronX));
+	const __m256 foldedY = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(1.0f), _mm256_and_ps(octahedronX, absoluteMask)),
+										 SignNotZero(octahedronY));
+	const __m256 lowerHemisphere = _mm256_cmp_ps(z, _mm256_setzero_ps(), _CMP_LT_OQ);
+
+	const __m128i packedX = PackSigned16(Quantize(_mm256_blendv_ps(octahedronX, foldedX, lowerHemisphere), -1.0f, 32767.0f));
+	const __m128i packedY = PackSigned16(Quantize(_mm256_blendv_ps(octahedronY, foldedY, lowerHemisphere), -1.0f, 32767.0f));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(packed), _mm_unpacklo_epi16(packedX, packedY));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(packed + PackBlockLength), _mm_unpackhi_epi16(packedX, packedY));
+}
+
+void PackOctahedral(const Float3* normals, usize count, int16* packed)
+{
+	usize i = 0;
+	for (; i + PackBlockLength <= count; i += PackBlockLength)
+	{
+		PackOctahedralBlock(normals + i, packed + i * 2);
+	}
+
+	// Padding with a valid normal keeps the unused lanes away from a division by zero.
+	if (i < count)
+	{
+		Float3 tailNormals[PackBlockLength];
+		int16 tailPacked[PackBlockLength * 2] = {};
+		for (usize j = 0; j < PackBlockLength; ++j)
+		{
+			tailNormals[j] = i + j < count ? normals[i + j] : Float3 { 0.0f, 0.0f, 1.0f };
+		}
+		PackOctahedralBlock(tailNormals, tailPacked);
+		Platform::MemoryCopy(packed + i * 2, tailPacked, (count - i) * 2 * sizeof(int16));
+	}
+}
+
+}
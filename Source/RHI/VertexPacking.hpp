@@ -0,0 +1,27 @@
+#pragma once
+
+#include "HLSL.hpp"
+
+#include "Luft/Base.hpp"
+
+// Quantizes mesh data at import into the storage formats of VertexFormat. Each function converts count values, eight
+// at a time with AVX2, rounding to nearest and clamping to the format's range.
+
+namespace RHI
+{
+
+// Float16x2 and Float16x4.
+void PackFloat16(const float* values, usize count, uint16* packed);
+
+// SNorm16x2 and SNorm16x4 from [-1, 1], UNorm16x2 and UNorm16x4 from [0, 1].
+void PackSNorm16(const float* values, usize count, int16* packed);
+void PackUNorm16(const float* values, usize count, uint16* packed);
+
+// SNorm8x4 from [-1, 1], UNorm8x4 from [0, 1].
+void PackSNorm8(const float* values, usize count, int8* packed);
+void PackUNorm8(const float* values, usize count, uint8* packed);
+
+// Unit vectors folded onto an octahedron, two SNorm16 values each, for SNorm16x2 normals and tangents.
+void PackOctahedral(const Float3* normals, usize count, int16* packed);
+
+}
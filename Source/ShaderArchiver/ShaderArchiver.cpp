@@ -0,0 +1,454 @@
+// Compiles a manifest of shaders into a single archive that the runtime maps instead of compiling HLSL.
+//
+// Usage: ShaderArchiver <manifest> <archive>
+//
+// Each manifest line names a stage, a shader path and any number of defines:
+//
+//     # Comment
+//     Vertex Shaders/Mesh.hlsl
+//     Pixel Shaders/Mesh.hlsl ALPHA_TEST=0|1 QUALITY=Low|High
+//
+// A define value may list alternatives separated by '|', and every combination becomes its own entry. The shader path
+// must be written exactly as the runtime passes it in ShaderDescription::FilePath.
+
+#include "RHI/ShaderArchive.hpp"
+#include "RHI/D3D12/ShaderReflection.hpp"
+
+#if PLATFORM_WINDOWS
+#include <Windows.h>
+#endif
+#include "dxc/dxcapi.h"
+#include "dxc/d3d12shader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
+
+#if PLATFORM_WINDOWS
+#define strtok_r strtok_s
+#endif
+
+static constexpr usize MaxLineLength = 1024;
+static constexpr usize MaxDefines = 16;
+static constexpr usize MaxAlternatives = 16;
+static constexpr usize MaxArguments = 64;
+
+struct Define
+{
+	char* Name;
+	char* Alternatives[MaxAlternatives];
+	usize AlternativeCount;
+};
+
+struct Entry
+{
+	RHI::ShaderArchiveEntry Record;
+	IDxcBlob* Blob;
+	RHI::ShaderReflection Reflection;
+};
+
+struct Entries
+{
+	Entry* Data;
+	usize Length;
+	usize Capacity;
+};
+
+static IDxcCompiler3* Compiler = nullptr;
+static IDxcUtils* Utils = nullptr;
+static IDxcIncludeHandler* IncludeHandler = nullptr;
+
+static void AddEntry(Entries* entries, const Entry& entry)
+{
+	if (entries->Length == entries->Capacity)
+	{
+		entries->Capacity = entries->Capacity ? entries->Capacity * 2 : 64;
+		entries->Data = static_cast<Entry*>(realloc(entries->Data, entries->Capacity * sizeof(Entry)));
+		if (!entries->Data)
+		{
+			fprintf(stderr, "ShaderArchiver: Out of memory!\n");
+			exit(EXIT_FAILURE);
+		}
+	}
+	entries->Data[entries->Length++] = entry;
+}
+
+static int CompareEntries(const void* a, const void* b)
+{
+	const uint64 keyA = static_cast<const Entry*>(a)->Record.Key;
+	const uint64 keyB = static_cast<const Entry*>(b)->Record.Key;
+	return keyA < keyB ? -1 : (keyA > keyB ? 1 : 0);
+}
+
+static wchar_t* ToWide(const char* input)
+{
+	const usize length = strlen(input);
+	wchar_t* output = static_cast<wchar_t*>(calloc(length + 1, sizeof(wchar_t)));
+	mbstowcs(output, input, length);
+	return output;
+}
+
+static bool ParseStage(const char* name, uint8* stage, const wchar_t** entryPoint, const wchar_t** profile)
+{
+	// Must match RHI::ShaderStage and the entry points used by DXC::CompileShader.
+	if (strcmp(name, "Vertex") == 0)
+	{
+		*stage = 0;
+		*entryPoint = L"VertexStart";
+		*profile = L"vs_6_6";
+		return true;
+	}
+	if (strcmp(name, "Pixel") == 0)
+	{
+		*stage = 1;
+		*entryPoint = L"PixelStart";
+		*profile = L"ps_6_6";
+		return true;
+	}
+	if (strcmp(name, "Compute") == 0)
+	{
+		*stage = 2;
+		*entryPoint = L"ComputeStart";
+		*profile = L"cs_6_6";
+		return true;
+	}
+	return false;
+}
+
+static bool Distill(IDxcResult* result, RHI::ShaderReflection* reflection)
+{
+	IDxcBlob* reflectionBlob = nullptr;
+	result->GetOutput(DXC_OUT_REFLECTION, IID_PPV_ARGS(&reflectionBlob), nullptr);
+	if (!reflectionBlob)
+	{
+		return false;
+	}
+
+	const DxcBuffer reflectionBuffer =
+	{
+		.Ptr = reflectionBlob->GetBufferPointer(),
+		.Size = reflectionBlob->GetBufferSize(),
+		.Encoding = 0,
+	};
+	ID3D12ShaderReflection* shaderReflection = nullptr;
+	const bool distilled = SUCCEEDED(Utils->CreateReflection(&reflectionBuffer, IID_PPV_ARGS(&shaderReflection))) &&
+						   DXC::DistillReflection(shaderReflection, reflection);
+
+	if (shaderReflection)
+	{
+		shaderReflection->Release();
+	}
+	reflectionBlob->Release();
+	return distilled;
+}
+
+static bool Compile(const char* filePath,
+					uint8 stage,
+					const wchar_t* entryPoint,
+					const wchar_t* profile,
+					const Define* defines,
+					const usize* choices,
+					usize defineCount,
+					Entries* entries)
+{
+	wchar_t* widePath = ToWide(filePath);
+
+	uint32 codePage = DXC_CP_UTF8;
+	IDxcBlobEncoding* source = nullptr;
+	if (FAILED(Utils->LoadFile(widePath, &codePage, &source)))
+	{
+		fprintf(stderr, "ShaderArchiver: Failed to read %s!\n", filePath);
+		free(widePath);
+		return false;
+	}
+
+	// Must match the Release arguments in DXC::CompileShader.
+	const wchar_t* arguments[MaxArguments] =
+	{
+		widePath,
+		L"-E", entryPoint,
+		L"-T", profile,
+		L"-HV", L"2021",
+		DXC_ARG_WARNINGS_ARE_ERRORS,
+		DXC_ARG_ALL_RESOURCES_BOUND,
+		L"-enable-16bit-types",
+		DXC_ARG_OPTIMIZATION_LEVEL3,
+		L"-Qstrip_debug",
+	};
+	usize argumentCount = 12;
+
+	wchar_t* defineArguments[MaxDefines] = {};
+	uint64 defineHashSum = 0;
+	for (usize i = 0; i < defineCount; ++i)
+	{
+		const char* name = defines[i].Name;
+		const char* value = defines[i].Alternatives[choices[i]];
+		defineHashSum += RHI::HashShaderArchiveDefine(name, strlen(name), value, strlen(value));
+
+		char define[MaxLineLength] = {};
+		snprintf(define, sizeof(define), "%s=%s", name, value);
+		defineArguments[i] = ToWide(define);
+		arguments[argumentCount++] = L"-D";
+		arguments[argumentCount++] = defineArguments[i];
+	}
+
+	const DxcBuffer buffer =
+	{
+		.Ptr = source->GetBufferPointer(),
+		.Size = source->GetBufferSize(),
+		.Encoding = DXC_CP_UTF8,
+	};
+	IDxcResult* result = nullptr;
+	const HRESULT compileResult = Compiler->Compile(&buffer,
+													arguments,
+													static_cast<uint32>(argumentCount),
+													IncludeHandler,
+													IID_PPV_ARGS(&result));
+
+	HRESULT status = compileResult;
+	if (SUCCEEDED(compileResult))
+	{
+		result->GetStatus(&status);
+	}
+
+	bool success = SUCCEEDED(status);
+	if (success)
+	{
+		Entry entry = {};
+		entry.Record.Key = RHI::HashShaderArchiveKey(filePath, strlen(filePath), stage, defineHashSum);
+		result->GetResult(&entry.Blob);
+		success = entry.Blob && Distill(result, &entry.Reflection);
+		if (success)
+		{
+			AddEntry(entries, entry);
+		}
+		else if (entry.Blob)
+		{
+			fprintf(stderr, "ShaderArchiver: %s binds resources that RHI::ShaderReflection cannot describe!\n", filePath);
+			entry.Blob->Release();
+		}
+	}
+	else if (result)
+	{
+		IDxcBlobEncoding* errors = nullptr;
+		result->GetErrorBuffer(&errors);
+		fprintf(stderr,
+				"ShaderArchiver: %s failed to compile:\n%.*s\n",
+				filePath,
+				errors ? static_cast<int>(errors->GetBufferSize()) : 0,
+				errors ? static_cast<const char*>(errors->GetBufferPointer()) : "");
+		if (errors)
+		{
+			errors->Release();
+		}
+	}
+
+	if (result)
+	{
+		result->Release();
+	}
+	source->Release();
+	for (usize i = 0; i < defineCount; ++i)
+	{
+		free(defineArguments[i]);
+	}
+	free(widePath);
+	return success;
+}
+
+static bool CompileLine(char* line, usize lineNumber, Entries* entries)
+{
+	static constexpr char separators[] = " \t\r\n";
+
+	char* context = nullptr;
+	const char* stageName = strtok_r(line, separators, &context);
+	if (!stageName || stageName[0] == '#')
+	{
+		return true;
+	}
+
+	uint8 stage = 0;
+	const wchar_t* entryPoint = nullptr;
+	const wchar_t* profile = nullptr;
+	const char* filePath = strtok_r(nullptr, separators, &context);
+	if (!ParseStage(stageName, &stage, &entryPoint, &profile) || !filePath)
+	{
+		fprintf(stderr, "ShaderArchiver: Line %zu: expected <Vertex|Pixel|Compute> <path> [NAME=VALUE|VALUE ...]\n", lineNumber);
+		return false;
+	}
+
+	Define defines[MaxDefines] = {};
+	usize defineCount = 0;
+	for (char* token = strtok_r(nullptr, separators, &context); token; token = strtok_r(nullptr, separators, &context))
+	{
+		char* equals = strchr(token, '=');
+		if (!equals || defineCount == MaxDefines)
+		{
+			fprintf(stderr, "ShaderArchiver: Line %zu: invalid or too many defines at '%s'\n", lineNumber, token);
+			return false;
+		}
+		*equals = '\0';
+
+		Define& define = defines[defineCount++];
+		define.Name = token;
+
+		char* alternativeContext = nullptr;
+		for (char* alternative = strtok_r(equals + 1, "|", &alternativeContext);
+			 alternative && define.AlternativeCount < MaxAlternatives;
+			 alternative = strtok_r(nullptr, "|", &alternativeContext))
+		{
+			define.Alternatives[define.AlternativeCount++] = alternative;
+		}
+		if (define.AlternativeCount == 0)
+		{
+			static char empty[] = "";
+			define.Alternatives[define.AlternativeCount++] = empty;
+		}
+	}
+
+	// Walk every combination of alternatives like an odometer.
+	bool success = true;
+	usize choices[MaxDefines] = {};
+	while (true)
+	{
+		success = Compile(filePath, stage, entryPoint, profile, defines, choices, defineCount, entries) && success;
+
+		usize digit = 0;
+		while (digit < defineCount && ++choices[digit] == defines[digit].AlternativeCount)
+		{
+			choices[digit++] = 0;
+		}
+		if (digit == defineCount)
+		{
+			break;
+		}
+	}
+	return success;
+}
+
+static bool WriteArchive(const char* path, Entries* entries)
+{
+	qsort(entries->Data, entries->Length, sizeof(Entry), CompareEntries);
+	for (usize i = 1; i < entries->Length; ++i)
+	{
+		if (entries->Data[i - 1].Record.Key == entries->Data[i].Record.Key)
+		{
+			fprintf(stderr, "ShaderArchiver: The manifest lists the same shader permutation twice!\n");
+			return false;
+		}
+	}
+
+	const auto align = [](uint64 offset) { return (offset + RHI::ShaderArchiveAlignment - 1) & ~(RHI::ShaderArchiveAlignment - 1); };
+
+	uint64 offset = align(sizeof(RHI::ShaderArchiveHeader) + entries->Length * sizeof(RHI::ShaderArchiveEntry));
+	for (usize i = 0; i < entries->Length; ++i)
+	{
+		Entry& entry = entries->Data[i];
+		entry.Record.BlobOffset = offset;
+		entry.Record.BlobSize = entry.Blob->GetBufferSize();
+		offset = align(offset + entry.Record.BlobSize);
+		entry.Record.ReflectionOffset = offset;
+		entry.Record.ReflectionSize = sizeof(entry.Reflection);
+		offset = align(offset + entry.Record.ReflectionSize);
+	}
+
+	FILE* file = fopen(path, "wb");
+	if (!file)
+	{
+		fprintf(stderr, "ShaderArchiver: Failed to open %s for writing!\n", path);
+		return false;
+	}
+
+	const RHI::ShaderArchiveHeader header =
+	{
+		.Magic = RHI::ShaderArchiveMagic,
+		.Version = RHI::ShaderArchiveVersion,
+		.EntryCount = entries->Length,
+	};
+	bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+	for (usize i = 0; i < entries->Length; ++i)
+	{
+		success = success && fwrite(&entries->Data[i].Record, sizeof(RHI::ShaderArchiveEntry), 1, file) == 1;
+	}
+
+	static constexpr uint8 padding[RHI::ShaderArchiveAlignment] = {};
+	for (usize i = 0; i < entries->Length && success; ++i)
+	{
+		const Entry& entry = entries->Data[i];
+		const struct
+		{
+			uint64 Offset;
+			const void* Data;
+			usize Size;
+		} chunks[] =
+		{
+			{ entry.Record.BlobOffset, entry.Blob->GetBufferPointer(), entry.Blob->GetBufferSize() },
+			{ entry.Record.ReflectionOffset, &entry.Reflection, sizeof(entry.Reflection) },
+		};
+		for (const auto& chunk : chunks)
+		{
+			const usize paddingSize = static_cast<usize>(chunk.Offset - static_cast<uint64>(ftell(file)));
+			success = success && fwrite(padding, 1, paddingSize, file) == paddingSize;
+			success = success && fwrite(chunk.Data, 1, chunk.Size, file) == chunk.Size;
+		}
+	}
+
+	success = fclose(file) == 0 && success;
+	if (!success)
+	{
+		fprintf(stderr, "ShaderArchiver: Failed to write %s!\n", path);
+	}
+	return success;
+}
+
+int main(int argumentCount, char** arguments)
+{
+	if (argumentCount != 3)
+	{
+		fprintf(stderr, "Usage: ShaderArchiver <manifest> <archive>\n");
+		return EXIT_FAILURE;
+	}
+
+	FILE* manifest = fopen(arguments[1], "r");
+	if (!manifest)
+	{
+		fprintf(stderr, "ShaderArchiver: Failed to open %s!\n", arguments[1]);
+		return EXIT_FAILURE;
+	}
+
+	if (FAILED(DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&Compiler))) ||
+		FAILED(DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&Utils))) ||
+		FAILED(Utils->CreateDefaultIncludeHandler(&IncludeHandler)))
+	{
+		fprintf(stderr, "ShaderArchiver: Failed to create the DXC compiler!\n");
+		return EXIT_FAILURE;
+	}
+
+	Entries entries = {};
+	bool success = true;
+
+	char line[MaxLineLength];
+	for (usize lineNumber = 1; fgets(line, sizeof(line), manifest); ++lineNumber)
+	{
+		success = CompileLine(line, lineNumber, &entries) && success;
+	}
+	fclose(manifest);
+
+	success = success && WriteArchive(arguments[2], &entries);
+	if (success)
+	{
+		printf("ShaderArchiver: Wrote %zu shaders to %s\n", entries.Length, arguments[2]);
+	}
+
+	for (usize i = 0; i < entries.Length; ++i)
+	{
+		entries.Data[i].Blob->Release();
+	}
+	free(entries.Data);
+
+	IncludeHandler->Release();
+	Utils->Release();
+	Compiler->Release();
+	return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}